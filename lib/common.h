@@ -67,20 +67,20 @@ static const Color YELLOW = Color{ 255, 255, 0 };          //!< Yellow.
 static const Color LIGHT_YELLOW = Color{ 255, 255, 153 };  //!< Light yellow.
 
 /// A color palette for later use.
-static std::map<std::string, Color> color_pallet{ { "black", BLACK },
-                                                  { "white", WHITE },
-                                                  { "dark_green", DARK_GREEN },
-                                                  { "red", RED },
-                                                  { "green", GREEN },
-                                                  { "blue", BLUE },
-                                                  { "crimson", CRIMSON },
-                                                  { "light_blue", LIGHT_BLUE },
-                                                  { "light_grey", LIGHT_GREY },
-                                                  { "deep_sky_blue", DEEP_SKY_BLUE },
-                                                  { "dodger_blue", DODGER_BLUE },
-                                                  { "steel_blue", STEEL_BLUE },
-                                                  { "yellow", YELLOW },
-                                                  { "light_yellow", LIGHT_YELLOW } };
+static const std::map<std::string, Color> color_pallet{ { "black", BLACK },
+                                                        { "white", WHITE },
+                                                        { "dark_green", DARK_GREEN },
+                                                        { "red", RED },
+                                                        { "green", GREEN },
+                                                        { "blue", BLUE },
+                                                        { "crimson", CRIMSON },
+                                                        { "light_blue", LIGHT_BLUE },
+                                                        { "light_grey", LIGHT_GREY },
+                                                        { "deep_sky_blue", DEEP_SKY_BLUE },
+                                                        { "dodger_blue", DODGER_BLUE },
+                                                        { "steel_blue", STEEL_BLUE },
+                                                        { "yellow", YELLOW },
+                                                        { "light_yellow", LIGHT_YELLOW } };
 
 }  // namespace life
 
@@ -0,0 +1,164 @@
+/**
+ * ActiveCells class implementation.
+ *
+ */
+
+#include "active_cells.h"
+#include "zobrist.h"
+#include <algorithm>
+
+namespace life {
+
+/**
+ * @brief Constructor for ActiveCells class. Every cell starts dead.
+ * @param rows # of rows.
+ * @param cols # of columns.
+ * @param boundary How the edges are glued together.
+ */
+ActiveCells :: ActiveCells(size_t rows, size_t cols, boundary_e boundary) :
+    m_rows(rows),
+    m_cols(cols),
+    m_boundary(boundary),
+    m_cells(rows * cols, 0),
+    m_candidates(),
+    m_evaluating(),
+    m_changes(),
+    m_population(0),
+    m_hash(0),
+    m_epoch(0),
+    m_stamps(((rows + tile_side - 1) / tile_side) * ((cols + tile_side - 1) / tile_side), 0),
+    m_rule()
+    {}
+
+/**
+ * @brief Returns the state of a cell.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @return True if the cell is alive.
+ */
+bool ActiveCells :: get(size_t row, size_t col) const{
+    return m_cells[row * m_cols + col] & alive_bit;
+};
+
+/**
+ * @brief Sets the state of a cell.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @param alive New state of the cell.
+ */
+void ActiveCells :: set(size_t row, size_t col, bool alive){
+    size_t cell = row * m_cols + col;
+    if (static_cast<bool>(m_cells[cell] & alive_bit) != alive){flip(cell);}
+};
+
+/**
+ * @brief Queues a cell for evaluation in the next generation.
+ * @param cell Index of the cell.
+ */
+void ActiveCells :: enqueue(size_t cell){
+    if ((m_cells[cell] & queued_bit) == 0){
+        m_cells[cell] |= queued_bit;
+        m_candidates.push_back(cell);
+    }
+};
+
+/**
+ * @brief Flips a cell, updating its neighbors' counts.
+ *
+ * The cell and its eight neighbors (across the edges, as the topology says)
+ * are queued, since they are the only cells whose next state may have changed.
+ * @param cell Index of the cell.
+ */
+void ActiveCells :: flip(size_t cell){
+    m_cells[cell] ^= alive_bit;
+    const bool alive = m_cells[cell] & alive_bit;
+    if (alive){m_population++;}
+    else {m_population--;}
+    enqueue(cell);
+
+    const size_t row = cell / m_cols;
+    const size_t col = cell % m_cols;
+    m_hash ^= cell_key(row, col);
+    // Flips made by a step carry its epoch once it ends; the ones made by set() are newer than epoch().
+    m_stamps[row / tile_side * tile_grid_cols() + col / tile_side] = m_epoch + 1;
+    const bool inside = row > 0 && col > 0 && row + 1 < m_rows && col + 1 < m_cols;
+    for (int i = -1; i <= 1; i++){
+        for (int j = -1; j <= 1; j++){
+            if (i == 0 && j == 0){continue;}
+            long long r = static_cast<long long>(row) + i;
+            long long c = static_cast<long long>(col) + j;
+            if (!inside && !boundary_source(m_boundary, m_rows, m_cols, r, c)){continue;}
+            size_t neighbor = static_cast<size_t>(r) * m_cols + static_cast<size_t>(c);
+            if (alive){m_cells[neighbor] += cell_t(1) << count_shift;}
+            else {m_cells[neighbor] -= cell_t(1) << count_shift;}
+            enqueue(neighbor);
+        }
+    }
+};
+
+/**
+ * @brief Advances the board one generation.
+ *
+ * The candidates are decided against the current counts first, and only
+ * then flipped, so every decision sees the same generation.
+ */
+void ActiveCells :: step_once(void){
+    // The lists trade places, so steady runs reuse their capacity.
+    m_evaluating.swap(m_candidates);
+    m_changes.clear();
+    for (size_t cell : m_evaluating){
+        cell_t state = m_cells[cell] & ~queued_bit;
+        m_cells[cell] = state;
+        unsigned n_alives = state >> count_shift;
+        bool alive = state & alive_bit;
+        bool next = m_rule.next(alive, n_alives);
+        if (next != alive){m_changes.push_back(cell);}
+    }
+    m_evaluating.clear();
+    for (size_t cell : m_changes){flip(cell);}
+    m_epoch++;
+};
+
+/**
+ * @brief Copies the cells of the board, 64 per word, row after row.
+ * @param out Receives rows() * ceil(cols() / 64) words.
+ */
+void ActiveCells :: snapshot(std :: vector<uint64_t>& out){
+    const size_t words = (m_cols + 63) / 64;
+    out.assign(m_rows * words, 0);
+    for (size_t r = 0; r < m_rows; r++){
+        for (size_t c = 0; c < m_cols; c++){
+            if (m_cells[r * m_cols + c] & alive_bit){out[r * words + c / 64] |= uint64_t(1) << (c % 64);}
+        }
+    }
+};
+
+/**
+ * @brief Copies a square block of cells, straight from the state bytes.
+ * @param tile_row Row of the block, in blocks.
+ * @param tile_col Column of the block, in blocks.
+ * @param side Side of the block, a multiple of 64.
+ * @param out Receives side rows of side / 64 words; cells past the board are dead.
+ */
+void ActiveCells :: read_tile(size_t tile_row, size_t tile_col, size_t side, uint64_t* out) const{
+    const size_t words = side / 64;
+    const size_t r0 = tile_row * side;
+    const size_t c0 = tile_col * side;
+    std :: fill(out, out + side * words, 0);
+    for (size_t i = 0; i < side && r0 + i < m_rows; i++){
+        const cell_t* cells = &m_cells[(r0 + i) * m_cols];
+        for (size_t j = 0; j < side && c0 + j < m_cols; j++){
+            if (cells[c0 + j] & alive_bit){out[i * words + j / 64] |= uint64_t(1) << (j % 64);}
+        }
+    }
+};
+
+/**
+ * @brief Advances the board by several generations.
+ * @param generations # of generations.
+ */
+void ActiveCells :: step(unsigned long long generations){
+    for (unsigned long long i = 0; i < generations; i++){step_once();}
+};
+
+}  // namespace life
@@ -0,0 +1,87 @@
+//! This class implements an activity-driven life engine.
+/*!
+ * @file active_cells.h
+ *
+ * @details Class ActiveCells, a bounded engine that only evaluates the cells
+ * whose neighborhood changed in the previous generation.
+ */
+
+#ifndef _ACTIVE_CELLS_H_
+#define _ACTIVE_CELLS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "boundary.h"
+#include "engine.h"
+
+namespace life {
+
+/// A bounded engine whose cost per generation follows the activity.
+/*!
+ * Every cell is one byte holding its state, its # of alive neighbors and
+ * a "queued" flag. The neighbor counts are kept up to date as cells flip,
+ * and a cell only has to be looked at again when it or one of its eight
+ * neighbors changed. A generation therefore touches the cells around the
+ * previous changes and nothing else: a single blinker on a 10k x 10k board
+ * costs a few dozen cells per generation. The flips also stamp their
+ * 64x64 tile, so the history and the painter only read the tiles that
+ * changed. The edges are glued as the topology given at construction says
+ * (see boundary.h).
+ */
+class ActiveCells : public Engine {
+    private:
+    typedef uint8_t cell_t;                         //!< State byte of a cell.
+    static constexpr cell_t alive_bit = 0x01;       //!< Cell is alive.
+    static constexpr cell_t queued_bit = 0x02;      //!< Cell is in the candidate list.
+    static constexpr unsigned count_shift = 2;      //!< Neighbor count, bits 2..5.
+    static constexpr size_t tile_side = 64;         //!< # of rows and columns of a stamped tile.
+
+    size_t m_rows;                      //!< # of rows.
+    size_t m_cols;                      //!< # of columns.
+    boundary_e m_boundary;              //!< How the edges are glued together.
+    std::vector<cell_t> m_cells;        //!< State byte of every cell.
+    std::vector<size_t> m_candidates;   //!< Cells to evaluate in the next generation.
+    std::vector<size_t> m_evaluating;   //!< Cells being evaluated in this generation.
+    std::vector<size_t> m_changes;      //!< Cells that flip in the current generation.
+    unsigned long long m_population;    //!< # of alive cells.
+    uint64_t m_hash;                    //!< Fingerprint, updated as cells flip.
+    unsigned long long m_epoch;         //!< # of generations stepped.
+    std::vector<unsigned long long> m_stamps;   //!< Epoch of the last change of each tile.
+    Rule m_rule;                        //!< Birth and survival conditions.
+
+    //!< Adds a cell to the candidate list, once.
+    void enqueue(size_t cell);
+
+    //!< Flips a cell and updates the counts and candidates around it.
+    void flip(size_t cell);
+
+    //!< Advances the board one generation.
+    void step_once(void);
+
+    //!< Returns the # of tile columns.
+    size_t tile_grid_cols(void) const { return (m_cols + tile_side - 1) / tile_side; }
+
+    public:
+    ActiveCells(size_t rows, size_t cols, boundary_e boundary = boundary_e :: TORUS);
+
+    size_t rows(void) const override { return m_rows; }
+    size_t cols(void) const override { return m_cols; }
+    bool get(size_t row, size_t col) const override;
+    void set(size_t row, size_t col, bool alive) override;
+    unsigned long long population(void) const override { return m_population; }
+    void step(unsigned long long generations) override;
+    void rule(const Rule& rule) override { m_rule = rule; }
+    uint64_t fingerprint(void) override { return m_hash; }
+    void snapshot(std::vector<uint64_t>& out) override;
+    void read_tile(size_t tile_row, size_t tile_col, size_t side, uint64_t* out) const override;
+    size_t tile_size(void) const override { return tile_side; }
+    unsigned long long epoch(void) const override { return m_epoch; }
+    unsigned long long tile_stamp(size_t tile_row, size_t tile_col) const override {
+        return m_stamps[tile_row * tile_grid_cols() + tile_col];
+    }
+};
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,123 @@
+//! Bitwise adders that decide 64 cells at once.
+/*!
+ * @file adder.h
+ *
+ * @details The kernel of the "adder" bitboard, also used by the bit-sliced
+ * boards: each bit of a word is one cell, and the neighbor counts of the 64
+ * cells are added column-wise with half/full adders. The functions only use
+ * bitwise operators, so they work on uint64_t and on vectors of them alike.
+ * They are always inlined, so that each caller compiles them for its own
+ * instruction set.
+ */
+
+#ifndef _ADDER_H_
+#define _ADDER_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include "rule.h"
+
+namespace life {
+
+/**
+ * @brief Selects the cells of a word that have a given neighbor count, and
+ * whose next state under a rule is alive.
+ * @param birth Neighbor counts that give birth.
+ * @param survive Neighbor counts that keep a cell alive.
+ * @param ones Ones digit of the counts.
+ * @param twos Twos digit of the counts.
+ * @param fours Fours digit of the counts.
+ * @param eights Eights digit of the counts.
+ * @param alive Current cells.
+ * @return Cells with N neighbors that are alive in the next generation.
+ */
+template <unsigned N, class W>
+inline __attribute__((always_inline)) W rule_term(uint16_t birth, uint16_t survive, W ones, W twos, W fours, W eights, W alive){
+    const bool born = (birth >> N) & 1;
+    const bool stays = (survive >> N) & 1;
+    if (!born && !stays){return W{};}
+    W count = ((N & 1) ? ones : ~ones) & ((N & 2) ? twos : ~twos)
+            & ((N & 4) ? fours : ~fours) & ((N & 8) ? eights : ~eights);
+    return count & (born ? (stays ? ~W{} : ~alive) : alive);
+}
+
+/**
+ * @brief Applies a rule to 64 cells, given the bits of their neighbor counts.
+ *
+ * The count of each cell is compared with every count of the rule. The
+ * comparisons are expanded at compile time, one per count, so that with
+ * constant masks only the ones the rule needs are left.
+ * @param birth Neighbor counts that give birth.
+ * @param survive Neighbor counts that keep a cell alive.
+ * @param ones Ones digit of the counts.
+ * @param twos Twos digit of the counts.
+ * @param fours Fours digit of the counts.
+ * @param eights Eights digit of the counts.
+ * @param alive Current cells.
+ * @return Next cells.
+ */
+template <class W, unsigned... N>
+inline __attribute__((always_inline)) W apply_rule(uint16_t birth, uint16_t survive, W ones, W twos, W fours, W eights, W alive,
+                    std::integer_sequence<unsigned, N...>){
+    return (rule_term<N>(birth, survive, ones, twos, fours, eights, alive) | ...);
+}
+
+/**
+ * @brief Computes the next state of a word of cells, given the rows above,
+ * at and below it shifted by one cell each way.
+ *
+ * The eight neighbor bits are added column-wise with bitwise half/full
+ * adders, so 64 cells are decided with a few dozen instructions and no
+ * branches. Conway's rule keeps its dedicated formula, and the other rules
+ * compare the full 4-bit neighbor count with their birth and survival
+ * masks, which fold into constants for the rules known at compile time.
+ * Bit-sliced boards (see SlicedBoards) hold one cell of 64 boards per word
+ * instead, and pass the words of columns col - 1, col and col + 1. W may
+ * also be a vector of words (see simd.h), to decide several words at once.
+ * @param birth Neighbor counts that give birth.
+ * @param survive Neighbor counts that keep a cell alive.
+ * @param west The three rows, cell col - 1 moved into col.
+ * @param mid The three rows.
+ * @param east The three rows, cell col + 1 moved into col.
+ * @return Next cells.
+ */
+template <class R, class W>
+inline __attribute__((always_inline)) W adder_word(uint16_t birth, uint16_t survive, const W* west, const W* mid, const W* east){
+    // 2-bit sums of the upper and lower triples, and of the middle pair.
+    W u1 = west[0] ^ mid[0] ^ east[0];
+    W u2 = (west[0] & mid[0]) | (east[0] & (west[0] ^ mid[0]));
+    W l1 = west[2] ^ mid[2] ^ east[2];
+    W l2 = (west[2] & mid[2]) | (east[2] & (west[2] ^ mid[2]));
+    W m1 = west[1] ^ east[1];
+    W m2 = west[1] & east[1];
+    // Ones digit of the total, and the carry it produces.
+    W ones = u1 ^ m1 ^ l1;
+    W k2 = (u1 & m1) | (l1 & (u1 ^ m1));
+    if constexpr (std::is_same<R, Conway>::value){
+        // The twos digit must receive exactly one of {u2, m2, l2, k2}
+        // for the total to be 2 or 3.
+        (void) birth;
+        (void) survive;
+        W p = u2 ^ m2;
+        W q = l2 ^ k2;
+        W twos_is_one = (p ^ q) & ~((u2 & m2) | (l2 & k2));
+        return twos_is_one & (ones | mid[1]);
+    }
+    else {
+        // Twos, fours and eights digits of the total.
+        W p = u2 ^ m2;
+        W q = l2 ^ k2;
+        W c1 = u2 & m2;
+        W c2 = l2 & k2;
+        W c3 = p & q;
+        W twos = p ^ q;
+        W fours = c1 ^ c2 ^ c3;
+        W eights = (c1 & c2) | (c3 & (c1 ^ c2));
+        return apply_rule(birth, survive, ones, twos, fours, eights, mid[1], std::make_integer_sequence<unsigned, 9>());
+    }
+}
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,1171 @@
+/**
+ * BitBoard class implementation.
+ *
+ */
+
+#include "bitboard.h"
+#include "adder.h"
+#include "simd.h"
+#include "lut.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace life {
+
+/**
+ * @brief Constructor for BitBoard class.
+ * @param rows # of rows.
+ * @param cols # of columns.
+ */
+BitBoard :: BitBoard(size_t rows, size_t cols) :
+    m_rows(0),
+    m_cols(0),
+    m_words(0),
+    m_last_mask(0),
+    m_board(),
+    m_schedule(schedule_e :: BANDS),
+    m_kernel(kernel_e :: ADDER),
+    m_boundary(boundary_e :: TORUS),
+    m_rule(),
+    m_span(&BitBoard :: step_span_adder<Conway>),
+    m_run_tiles(&BitBoard :: step_run_adder<Conway>),
+    m_simd(simd_support()),
+    m_run(adder_run_for<Conway>(m_simd)),
+    m_lut3(lut3x3.data()),
+    m_lut4(lut4x4.data()),
+    m_rule_lut3(),
+    m_rule_lut4(),
+    m_queues(),
+    m_pool(nullptr),
+    m_epoch(0),
+    m_stamps(),
+    m_active(),
+    m_changed(),
+    m_deltas(),
+    m_depth(1),
+    m_locals(),
+    m_step_row(&BitBoard :: step_row<Conway>),
+    m_halo_stamp(1),
+    m_hash(0)
+    {
+        resize(rows, cols);
+    }
+
+/**
+ * @brief Resizes the board. Every cell starts dead.
+ *
+ * With a thread pool, each worker zeroes the band of rows it steps (see
+ * step_once()), so on a NUMA host the pages of the band are placed on the
+ * node of that worker by the first touch, rather than all on the node of
+ * the calling thread.
+ * @param rows # of rows.
+ * @param cols # of columns.
+ */
+void BitBoard :: resize(size_t rows, size_t cols){
+    m_rows = rows;
+    m_cols = cols;
+    m_words = (cols + word_bits - 1) / word_bits;
+    size_t tail = cols % word_bits;
+    m_last_mask = (tail == 0) ? ~word_t(0) : ((word_t(1) << tail) - 1);
+    const size_t workers = (m_pool == nullptr) ? 1 : m_pool->size();
+    m_board.resize(m_rows, m_words, workers == 1);
+    if (workers > 1){
+        const size_t grid_rows = tile_grid_rows();
+        m_pool->run([this, workers, grid_rows](size_t worker){
+            const size_t begin = worker * grid_rows / workers * tile_rows;
+            const size_t end = (worker + 1) * grid_rows / workers * tile_rows;
+            m_board.clear(std :: min(begin, m_rows), std :: min(end, m_rows));
+        });
+    }
+    // Every tile starts as changed, so the first generation computes them all.
+    m_epoch = 0;
+    m_stamps.assign(tile_grid_rows() * tile_grid_cols(), 1);
+    m_active.assign(m_stamps.size(), true);
+    m_changed.assign(m_stamps.size(), false);
+    m_deltas.assign(m_stamps.size(), 0);
+    m_halo_stamp = 1;
+    m_hash = 0;
+};
+
+/**
+ * @brief Returns the state of a cell.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @return True if the cell is alive.
+ */
+bool BitBoard :: get(size_t row, size_t col) const{
+    return (m_board.row(row)[col / word_bits] >> (col % word_bits)) & 1;
+};
+
+/**
+ * @brief Sets the state of a cell.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @param alive New state of the cell.
+ */
+void BitBoard :: set(size_t row, size_t col, bool alive){
+    word_t bit = word_t(1) << (col % word_bits);
+    word_t& word = m_board.row(row)[col / word_bits];
+    if (static_cast<bool>(word & bit) == alive){return;}
+    const size_t index = row * m_words + col / word_bits;
+    m_hash ^= word_key(index, word) ^ word_key(index, word ^ bit);
+    word ^= bit;
+    // Changed after the last step: the tile and its neighbors must be computed.
+    m_stamps[row / tile_rows * tile_grid_cols() + col / word_bits / tile_words] = m_epoch + 1;
+};
+
+/**
+ * @brief Counts the alive cells of the board.
+ * @return # of alive cells.
+ */
+unsigned long long BitBoard :: population(void) const{
+    unsigned long long total = 0;
+    for (size_t r = 0; r < m_rows; r++){
+        const word_t* x = row(r);
+        for (size_t w = 0; w < m_words; w++){
+            total += static_cast<unsigned long long>(__builtin_popcountll(x[w]));
+        }
+    }
+    return total;
+};
+
+/**
+ * @brief Copies a square block of cells, straight from the packed rows.
+ * @param tile_row Row of the block, in blocks.
+ * @param tile_col Column of the block, in blocks.
+ * @param side Side of the block, a multiple of 64.
+ * @param out Receives side rows of side / 64 words; cells past the board are dead.
+ */
+void BitBoard :: read_tile(size_t tile_row, size_t tile_col, size_t side, uint64_t* out) const{
+    const size_t words = side / word_bits;
+    const size_t r0 = tile_row * side;
+    const size_t w0 = tile_col * words;
+    for (size_t i = 0; i < side; i++){
+        for (size_t w = 0; w < words; w++){
+            out[i * words + w] = (r0 + i < m_rows && w0 + w < m_words) ? row(r0 + i)[w0 + w] : 0;
+        }
+    }
+};
+
+/**
+ * @brief Copies the cells of the board, row after row, without padding.
+ * @param out Receives rows() * words_per_row() words.
+ */
+void BitBoard :: snapshot(std :: vector<uint64_t>& out){
+    out.resize(m_rows * m_words);
+    for (size_t r = 0; r < m_rows; r++){
+        std :: copy(row(r), row(r) + m_words, out.begin() + r * m_words);
+    }
+};
+
+/**
+ * @brief Advances the board by several generations.
+ *
+ * With a depth above 1 (and the adder kernel, on any topology but the
+ * cross-surface), the generations go by passes of up to depth generations
+ * each; see step_blocked(). On the same conditions, the wavefront schedule
+ * steps all of them in a single pass of the threads; see step_wavefront().
+ * @param generations # of generations.
+ */
+void BitBoard :: step(unsigned long long generations){
+    if (m_schedule == schedule_e :: WAVEFRONT && m_pool != nullptr && m_pool->size() > 1 && generations > 1 &&
+        m_kernel == kernel_e :: ADDER && m_boundary != boundary_e :: CROSS){
+        step_wavefront(generations);
+        return;
+    }
+    if (m_depth > 1 && m_kernel == kernel_e :: ADDER && m_boundary != boundary_e :: CROSS){
+        while (generations > 1){
+            const unsigned depth = static_cast<unsigned>(std :: min<unsigned long long>(generations, m_depth));
+            step_blocked(depth);
+            generations -= depth;
+        }
+    }
+    for (unsigned long long i = 0; i < generations; i++){step_once();}
+};
+
+/**
+ * @brief Sets the # of generations advanced per pass over the board.
+ * @param generations Depth of the passes, 1 (one generation per pass) to tile_rows.
+ */
+void BitBoard :: depth(unsigned generations){
+    m_depth = std :: max(1u, std :: min<unsigned>(generations, tile_rows));
+};
+
+/**
+ * @brief Advances the board one generation, on the thread pool if one was set.
+ *
+ * Only the tiles next to a change of the previous generation are computed.
+ * A skipped tile did not change last generation, so both buffers already
+ * hold the same cells there and the swap keeps it right.
+ */
+void BitBoard :: step_once(void){
+    const size_t n_tiles = m_stamps.size();
+    mark_active();
+    fill_halo();
+    ThreadPool* pool = m_pool;
+    if (pool == nullptr || pool->size() == 1){
+        step_tiles(0, n_tiles);
+    }
+    else if (m_schedule == schedule_e :: TILES){
+        // Tiles are dealt in row-major order, so each worker starts on a
+        // compact region and only steals once its own share is done.
+        m_queues.reset(n_tiles, pool->size());
+        pool->run([this](size_t worker){
+            size_t tile;
+            while (m_queues.next(worker, tile)){step_tile(tile);}
+        });
+    }
+    else {
+        // Horizontal bands of tile rows, one per worker. Bands only read the
+        // current buffer, so the rows wrapping around the band edges need no care.
+        const size_t bands = pool->size();
+        const size_t grid_rows = tile_grid_rows();
+        const size_t grid_cols = tile_grid_cols();
+        pool->run([this, bands, grid_rows, grid_cols](size_t worker){
+            size_t begin = worker * grid_rows / bands * grid_cols;
+            size_t end = (worker + 1) * grid_rows / bands * grid_cols;
+            step_tiles(begin, end);
+        });
+    }
+    m_epoch++;
+    for (size_t tile = 0; tile < n_tiles; tile++){
+        if (m_changed[tile]){
+            m_stamps[tile] = m_epoch;
+            m_hash ^= m_deltas[tile];
+        }
+    }
+    m_board.swap();
+};
+
+/**
+ * @brief Flags the tiles that changed, or have a neighbor tile on the board
+ * that changed, in the previous generation. The neighbors across the edges
+ * are taken care of by fill_halo().
+ */
+void BitBoard :: mark_active(void){
+    const size_t grid_rows = tile_grid_rows();
+    const size_t grid_cols = tile_grid_cols();
+    // Neighbors past the edges are clamped to the tile itself.
+    for (size_t tr = 0; tr < grid_rows; tr++){
+        const size_t rows[3] = {(tr == 0) ? tr : tr - 1, tr, (tr + 1 == grid_rows) ? tr : tr + 1};
+        for (size_t tc = 0; tc < grid_cols; tc++){
+            const size_t cols[3] = {(tc == 0) ? tc : tc - 1, tc, (tc + 1 == grid_cols) ? tc : tc + 1};
+            bool active = false;
+            for (int i = 0; i < 3 && !active; i++){
+                for (int j = 0; j < 3 && !active; j++){
+                    active = m_stamps[rows[i] * grid_cols + cols[j]] >= m_epoch;
+                }
+            }
+            m_active[tr * grid_cols + tc] = active;
+        }
+    }
+};
+
+/**
+ * @brief Fills the halo of the current generation, as the topology of the
+ * board says, and flags the edge tiles whose halo may have changed.
+ *
+ * The ghost words on the sides are filled first, so that the ghost rows,
+ * copied from whole rows when the edges are not mirrored, get the corners
+ * right. A ghost cell is only written if the cell it stands for may have
+ * changed since this buffer was last filled, two generations ago, so a
+ * quiet board does not touch every row for its side ghosts; after a change
+ * of topology or a pass of step_blocked(), both buffers are filled in full. An edge tile
+ * is active if the tile of a ghost cell next to it changed in the previous
+ * generation, as mark_active() does on the board.
+ */
+void BitBoard :: fill_halo(void){
+    if (m_rows == 0 || m_words == 0){return;}
+    const size_t grid_cols = tile_grid_cols();
+    const long long n_rows = static_cast<long long>(m_rows);
+    const long long n_cols = static_cast<long long>(m_cols);
+    const unsigned long long epoch = m_epoch;
+    const bool refill = m_halo_stamp + 1 >= epoch;
+    // Maps a ghost cell to the cell it stands for (row -1 if always dead),
+    // and returns the epoch of the last change of that cell's tile.
+    auto locate = [this, grid_cols](long long& r, long long& c){
+        if (!boundary_source(m_boundary, m_rows, m_cols, r, c)){
+            r = -1;
+            return 0ULL;
+        }
+        return m_stamps[static_cast<size_t>(r) / tile_rows * grid_cols + static_cast<size_t>(c) / word_bits / tile_words];
+    };
+    auto alive = [this](long long r, long long c){ return r >= 0 && get(static_cast<size_t>(r), static_cast<size_t>(c)); };
+    // Flags the tiles holding cells (rows r0..r1, cols c0..c1), clipped to the board.
+    auto activate = [this, grid_cols, n_rows, n_cols](long long r0, long long r1, long long c0, long long c1){
+        const size_t tr0 = static_cast<size_t>(std :: max(r0, 0LL)) / tile_rows;
+        const size_t tr1 = static_cast<size_t>(std :: min(r1, n_rows - 1)) / tile_rows;
+        const size_t tc0 = static_cast<size_t>(std :: max(c0, 0LL)) / word_bits / tile_words;
+        const size_t tc1 = static_cast<size_t>(std :: min(c1, n_cols - 1)) / word_bits / tile_words;
+        for (size_t tr = tr0; tr <= tr1; tr++){
+            for (size_t tc = tc0; tc <= tc1; tc++){m_active[tr * grid_cols + tc] = true;}
+        }
+    };
+    for (long long r = 0; r < n_rows; r++){
+        for (long long c : {-1LL, n_cols}){
+            long long sr = r, sc = c;
+            const unsigned long long stamp = locate(sr, sc);
+            const long long edge = (c < 0) ? 0 : n_cols - 1;
+            if (stamp >= epoch){activate(r - 1, r + 1, edge, edge);}
+            if (!refill && stamp + 1 < epoch){continue;}
+            word_t* x = m_board.row(static_cast<size_t>(r));
+            if (c < 0){x[-1] = word_t(alive(sr, sc)) << 63;}
+            else {x[m_words] = word_t(alive(sr, sc));}
+        }
+    }
+    const size_t stride = m_board.stride();
+    for (long long r : {-1LL, n_rows}){
+        word_t* x = (r < 0) ? m_board.row(0) - stride : m_board.row(m_rows);
+        const long long edge = (r < 0) ? 0 : n_rows - 1;
+        if (m_boundary == boundary_e :: DEAD){
+            std :: fill(x - 1, x + m_words + 1, word_t(0));
+            continue;
+        }
+        if (m_boundary == boundary_e :: TORUS){
+            const size_t from = (r < 0) ? m_rows - 1 : 0;
+            std :: copy(m_board.row(from) - 1, m_board.row(from) + m_words + 1, x - 1);
+            // Whole tiles of the opposite edge, wrapping around for the corners.
+            const size_t tr = from / tile_rows;
+            for (size_t tc = 0; tc < grid_cols; tc++){
+                if (m_stamps[tr * grid_cols + tc] < epoch){continue;}
+                const long long c0 = static_cast<long long>(tc * tile_words * word_bits);
+                const long long c1 = std :: min(c0 + static_cast<long long>(tile_words * word_bits), n_cols) - 1;
+                activate(edge, edge, c0 - 1, c1 + 1);
+                if (tc == 0){activate(edge, edge, n_cols - 1, n_cols - 1);}
+                if (tc + 1 == grid_cols){activate(edge, edge, 0, 0);}
+            }
+            continue;
+        }
+        for (long long c = -1; c <= n_cols; c++){
+            long long sr = r, sc = c;
+            const unsigned long long stamp = locate(sr, sc);
+            if (stamp >= epoch){activate(edge, edge, c - 1, c + 1);}
+            if (!refill && stamp + 1 < epoch){continue;}
+            word_t& word = (c < 0) ? x[-1] : (c == n_cols) ? x[m_words] : x[c / word_bits];
+            const word_t bit = (c < 0) ? word_t(1) << 63 : (c == n_cols) ? word_t(1) : word_t(1) << (c % word_bits);
+            if (alive(sr, sc)){word |= bit;}
+            else {word &= ~bit;}
+        }
+    }
+};
+
+/**
+ * @brief Advances the board several generations in one pass (temporal blocking).
+ *
+ * A generation by generation sweep reads and writes the whole board each
+ * time, so boards larger than the caches are bound by memory bandwidth.
+ * Here each band of tile_rows rows is copied, with depth more rows on each
+ * side, into a scratch board small enough to stay in cache, and advanced
+ * depth generations there. The rows computed shrink by one on each side
+ * per generation, so the band itself is exact at the end, and only it is
+ * written back: the board is read and written once per depth generations,
+ * for depth / tile_rows redundant work on the extra rows.
+ *
+ * A change reaches one row further per generation, so a band with no
+ * changed tile within depth rows (counted with the real band heights, as
+ * the last band may be short) since the previous step is skipped. A
+ * tile that changed at any point of the pass is stamped with its end, and
+ * the fingerprint gets the keys of the words that differ at the end.
+ * @param depth # of generations, 2 to tile_rows.
+ */
+void BitBoard :: step_blocked(unsigned depth){
+    const size_t grid_rows = tile_grid_rows();
+    const size_t grid_cols = tile_grid_cols();
+    const size_t n_tiles = m_stamps.size();
+    if (n_tiles == 0){return;}
+    const bool wraps = m_boundary != boundary_e :: DEAD;
+    std :: vector<uint8_t> stamped(grid_rows, 0);
+    for (size_t tr = 0; tr < grid_rows; tr++){
+        for (size_t tc = 0; tc < grid_cols && !stamped[tr]; tc++){stamped[tr] = m_stamps[tr * grid_cols + tc] >= m_epoch;}
+    }
+    auto height = [this](size_t band){ return std :: min<size_t>(tile_rows, m_rows - band * tile_rows); };
+    for (size_t tr = 0; tr < grid_rows; tr++){
+        bool active = stamped[tr];
+        // A change d rows away reaches the band in d generations: the bands
+        // are walked outwards, by their real heights, until depth rows are covered.
+        for (int dir = -1; dir <= 1 && !active; dir += 2){
+            size_t band = tr;
+            for (size_t gap = 0, k = 1; gap < depth && k < grid_rows && !active; k++){
+                if (dir < 0){
+                    if (band == 0 && !wraps){break;}
+                    band = (band == 0) ? grid_rows - 1 : band - 1;
+                }
+                else {
+                    if (band + 1 == grid_rows && !wraps){break;}
+                    band = (band + 1 == grid_rows) ? 0 : band + 1;
+                }
+                active = stamped[band];
+                gap += height(band);
+            }
+        }
+        for (size_t tc = 0; tc < grid_cols; tc++){m_active[tr * grid_cols + tc] = active;}
+    }
+    ThreadPool* pool = m_pool;
+    const size_t workers = (pool == nullptr) ? 1 : pool->size();
+    if (m_locals.size() != workers){m_locals.resize(workers);}
+    // Sized for the deepest passes, so that shorter ones reuse them, and
+    // allocated by the worker that uses it, so it is on its NUMA node.
+    const size_t n_local = tile_rows + 2 * std :: max(depth, m_depth);
+    auto scratch = [this, n_local](size_t worker) -> Board& {
+        Board& local = m_locals[worker];
+        if (local.rows() < n_local || local.words() != m_words){local.resize(n_local, m_words);}
+        return local;
+    };
+    if (workers == 1){
+        Board& local = scratch(0);
+        for (size_t band = 0; band < grid_rows; band++){step_band(band, depth, local);}
+    }
+    else {
+        pool->run([this, workers, grid_rows, depth, &scratch](size_t worker){
+            size_t begin = worker * grid_rows / workers;
+            size_t end = (worker + 1) * grid_rows / workers;
+            Board& local = scratch(worker);
+            for (size_t band = begin; band < end; band++){step_band(band, depth, local);}
+        });
+    }
+    m_epoch += depth;
+    for (size_t tile = 0; tile < n_tiles; tile++){
+        if (m_changed[tile]){m_stamps[tile] = m_epoch;}
+        m_hash ^= m_deltas[tile];
+    }
+    // Neither buffer has a halo for the current cells.
+    m_halo_stamp = m_epoch;
+    m_board.swap();
+};
+
+/**
+ * @brief Reverses the bits of a word.
+ * @param x Word.
+ * @return Bit 63 - j of x at bit j.
+ */
+static inline BitBoard :: word_t reverse_bits(BitBoard :: word_t x){
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((x & 0x0f0f0f0f0f0f0f0fULL) << 4);
+    x = ((x >> 8) & 0x00ff00ff00ff00ffULL) | ((x & 0x00ff00ff00ff00ffULL) << 8);
+    x = ((x >> 16) & 0x0000ffff0000ffffULL) | ((x & 0x0000ffff0000ffffULL) << 16);
+    return (x >> 32) | (x << 32);
+}
+
+/**
+ * @brief Returns a word of a row with its cells in reverse order.
+ * @param from The row.
+ * @param w Index of the word.
+ * @param n_words # of words per row.
+ * @param pad # of bits past the last column in the last word.
+ * @return Cell cols - 1 - c of the row at cell c.
+ */
+static inline BitBoard :: word_t mirror_word(const BitBoard :: word_t* from, size_t w, size_t n_words, unsigned pad){
+    const size_t last = n_words - 1;
+    const BitBoard :: word_t lo = reverse_bits(from[last - w]);
+    const BitBoard :: word_t hi = (w == last) ? 0 : reverse_bits(from[last - w - 1]);
+    return (pad == 0) ? lo : (lo >> pad) | (hi << (BitBoard :: word_bits - pad));
+}
+
+/**
+ * @brief Writes a row with its cells in reverse order.
+ * @param from The row.
+ * @param x Receives cell cols - 1 - c of the row at cell c.
+ * @param n_words # of words per row.
+ * @param pad # of bits past the last column in the last word.
+ */
+static inline void mirror_row(const BitBoard :: word_t* from, BitBoard :: word_t* x, size_t n_words, unsigned pad){
+    for (size_t w = 0; w < n_words; w++){x[w] = mirror_word(from, w, n_words, pad);}
+}
+
+/**
+ * @brief Sets every cell of a row at once.
+ *
+ * As set(), cell by cell, but a word at a time: the words that change are
+ * rekeyed in the fingerprint and their tiles are computed in the next
+ * generation.
+ * @param r Row index.
+ * @param words words_per_row() words of cells, 64 per word; bits past the last column are ignored.
+ * @param mirrored True to set the cells in reverse order (cell cols - 1 - c of words at cell c).
+ */
+void BitBoard :: set_row(size_t r, const word_t* words, bool mirrored){
+    word_t* x = m_board.row(r);
+    const unsigned pad = static_cast<unsigned>(m_words * word_bits - m_cols);
+    for (size_t w = 0; w < m_words; w++){
+        word_t word = mirrored ? mirror_word(words, w, m_words, pad) : words[w];
+        if (w + 1 == m_words){word &= m_last_mask;}
+        if (word == x[w]){continue;}
+        const size_t index = r * m_words + w;
+        m_hash ^= word_key(index, x[w]) ^ word_key(index, word);
+        x[w] = word;
+        m_stamps[r / tile_rows * tile_grid_cols() + w / tile_words] = m_epoch + 1;
+    }
+};
+
+/**
+ * @brief Advances one band of the board depth generations, in a scratch board.
+ * @param band Index of the band (a row of tiles).
+ * @param depth # of generations.
+ * @param local Scratch board of at least tile_rows + 2 * depth rows.
+ */
+void BitBoard :: step_band(size_t band, unsigned depth, Board& local){
+    const size_t grid_cols = tile_grid_cols();
+    const size_t first = band * tile_rows;
+    const size_t height = std :: min(first + tile_rows, m_rows) - first;
+    const size_t n_local = height + 2 * depth;
+    const size_t n_words = m_words;
+    const size_t last = n_words - 1;
+    const size_t stride = local.stride();
+    const unsigned top_bit = static_cast<unsigned>((m_cols - 1) % word_bits);
+    const unsigned pad = static_cast<unsigned>(n_words * word_bits - m_cols);
+    word_t* deltas = m_deltas.data() + band * grid_cols;
+    uint8_t* changed = m_changed.data() + band * grid_cols;
+    if (!m_active[band * grid_cols]){
+        std :: fill(deltas, deltas + grid_cols, uint64_t(0));
+        std :: fill(changed, changed + grid_cols, uint8_t(0));
+        return;
+    }
+    // Local row j is board row first - depth + j; rows past the edges come
+    // from the other side (mirrored on a Klein bottle), or are dead.
+    const long long n_rows = static_cast<long long>(m_rows);
+    std :: vector<uint8_t> outside(n_local, 0);
+    for (size_t j = 0; j < n_local; j++){
+        long long g = static_cast<long long>(first + j) - static_cast<long long>(depth);
+        const bool is_outside = g < 0 || g >= n_rows;
+        bool mirrored = false;
+        while (g < 0 || g >= n_rows){
+            g += (g < 0) ? n_rows : -n_rows;
+            mirrored = !mirrored;
+        }
+        word_t* x = local.row(j);
+        if (is_outside && m_boundary == boundary_e :: DEAD){
+            outside[j] = true;
+            std :: fill(x, x + n_words, word_t(0));
+            continue;
+        }
+        const word_t* from = row(static_cast<size_t>(g));
+        if (!mirrored || m_boundary == boundary_e :: TORUS){
+            std :: copy(from, from + n_words, x);
+            continue;
+        }
+        mirror_row(from, x, n_words, pad);
+    }
+    std :: vector<word_t> diff(n_words, 0);
+    for (unsigned i = 1; i <= depth; i++){
+        // Rows i - 1 to n_local - i are exact after i - 1 generations.
+        for (size_t j = i - 1; j <= n_local - i; j++){
+            word_t* x = local.row(j);
+            if (m_boundary == boundary_e :: DEAD){
+                x[-1] = 0;
+                x[n_words] = 0;
+            }
+            else {
+                x[-1] = ((x[last] >> top_bit) & 1) << 63;
+                x[n_words] = x[0] & 1;
+            }
+        }
+        for (size_t j = i; j < n_local - i; j++){
+            word_t* out = local.next_row(j);
+            if (outside[j]){
+                std :: fill(out, out + n_words, word_t(0));
+                continue;
+            }
+            const word_t* x = local.row(j);
+            const bool core = j >= depth && j < depth + height;
+            (*m_step_row)(x - stride, x, x + stride, out, n_words, m_last_mask, top_bit, m_rule, m_run, core ? diff.data() : nullptr);
+        }
+        local.swap();
+    }
+    std :: fill(deltas, deltas + grid_cols, uint64_t(0));
+    for (size_t j = depth; j < depth + height; j++){
+        const size_t r = first + j - depth;
+        const word_t* now = local.row(j);
+        const word_t* was = row(r);
+        word_t* out = m_board.next_row(r);
+        for (size_t w = 0; w < n_words; w++){
+            out[w] = now[w];
+            if (now[w] != was[w]){deltas[w / tile_words] ^= word_key(r * n_words + w, was[w]) ^ word_key(r * n_words + w, now[w]);}
+        }
+    }
+    for (size_t tc = 0; tc < grid_cols; tc++){
+        bool any = false;
+        for (size_t w = tc * tile_words; w < std :: min((tc + 1) * tile_words, n_words); w++){any |= diff[w] != 0;}
+        changed[tc] = any;
+    }
+};
+
+/**
+ * @brief Advances the board several generations without a barrier per generation.
+ *
+ * Each worker owns a static set of bands (rows of tiles), and each band
+ * counts the generations it has computed. A band may compute generation
+ * gen + 1 as soon as the bands next to it (across the edges too, unless
+ * they are dead) hold generation gen: it then only reads cells they no
+ * longer overwrite, and overwrites cells they no longer read, since
+ * generation gen is read from one buffer and gen + 1 written to the other.
+ * A slow band only holds back its neighbors, not the whole board, so
+ * several generations are in flight at once and the only barrier is at the
+ * end of the call.
+ *
+ * A band whose neighbors and itself did not change in the previous
+ * generation is skipped, as are the tiles in step_once(). Tiles are
+ * stamped with the generation of their last change, and the fingerprint
+ * gets the keys of the words that change in each generation.
+ * @param generations # of generations, at least 1.
+ */
+void BitBoard :: step_wavefront(unsigned long long generations){
+    const size_t grid_rows = tile_grid_rows();
+    if (grid_rows == 0 || m_words == 0){return;}
+    const size_t workers = m_pool->size();
+    const bool wraps = m_boundary != boundary_e :: DEAD;
+    // Both buffers hold a whole halo, so skipped bands are right in either.
+    m_halo_stamp = m_epoch;
+    fill_halo();
+    if (!wraps){
+        const size_t stride = m_board.stride();
+        std :: fill(m_board.next_row(0) - stride - 1, m_board.next_row(0) + m_words + 1, word_t(0));
+        std :: fill(m_board.next_row(m_rows) - 1, m_board.next_row(m_rows) + m_words + 1, word_t(0));
+    }
+    // Generations computed by each band, and the last one that changed it.
+    std :: vector<std :: atomic<unsigned long long>> done(grid_rows);
+    std :: vector<std :: atomic<unsigned long long>> changed(grid_rows);
+    for (size_t band = 0; band < grid_rows; band++){
+        done[band].store(0, std :: memory_order_relaxed);
+        changed[band].store(0, std :: memory_order_relaxed);
+    }
+    std :: vector<uint64_t> deltas(workers, 0);
+    m_pool->run([this, &done, &changed, &deltas, workers, grid_rows, generations, wraps](size_t worker){
+        const size_t begin = worker * grid_rows / workers;
+        const size_t end = (worker + 1) * grid_rows / workers;
+        // Bands above and below a band, itself past the edges of a dead board.
+        auto above = [grid_rows, wraps](size_t band){ return band > 0 ? band - 1 : wraps ? grid_rows - 1 : band; };
+        auto below = [grid_rows, wraps](size_t band){ return band + 1 < grid_rows ? band + 1 : wraps ? 0 : band; };
+        uint64_t delta = 0;
+        size_t left = end - begin;
+        while (left > 0){
+            bool progress = false;
+            for (size_t band = begin; band < end; band++){
+                const unsigned long long gen = done[band].load(std :: memory_order_relaxed);
+                if (gen == generations){continue;}
+                const size_t up = above(band), down = below(band);
+                if (done[up].load(std :: memory_order_acquire) < gen || done[down].load(std :: memory_order_acquire) < gen){continue;}
+                const bool active = changed[band].load(std :: memory_order_relaxed) >= gen ||
+                                    changed[up].load(std :: memory_order_relaxed) >= gen ||
+                                    changed[down].load(std :: memory_order_relaxed) >= gen;
+                if (active && step_wave_band(band, gen, delta)){changed[band].store(gen + 1, std :: memory_order_relaxed);}
+                done[band].store(gen + 1, std :: memory_order_release);
+                if (gen + 1 == generations){left--;}
+                progress = true;
+            }
+            if (!progress){std :: this_thread :: yield();}
+        }
+        deltas[worker] = delta;
+    });
+    m_epoch += generations;
+    for (uint64_t delta : deltas){m_hash ^= delta;}
+    if (generations % 2 == 1){m_board.swap();}
+    // The halo of the other buffer is older than fill_halo() expects.
+    m_halo_stamp = m_epoch;
+};
+
+/**
+ * @brief Computes one band of the next generation, for step_wavefront().
+ *
+ * Generation gen is in the front buffer if gen is even (counting from the
+ * start of the pass), in the back buffer otherwise, and gen + 1 goes to
+ * the other one, halo included: the ghost words of each row, and the ghost
+ * row that stands for the first or last row of the board.
+ * @param band Index of the band (a row of tiles).
+ * @param gen Generation of the band, since the start of the pass.
+ * @param delta Receives the fingerprint change of the band.
+ * @return True if any cell of the band changed.
+ */
+bool BitBoard :: step_wave_band(size_t band, unsigned long long gen, uint64_t& delta){
+    const size_t grid_cols = tile_grid_cols();
+    const size_t n_words = m_words;
+    const size_t last = n_words - 1;
+    const size_t stride = m_board.stride();
+    const unsigned top_bit = static_cast<unsigned>((m_cols - 1) % word_bits);
+    const unsigned pad = static_cast<unsigned>(n_words * word_bits - m_cols);
+    const bool even = gen % 2 == 0;
+    const bool wraps = m_boundary != boundary_e :: DEAD;
+    const size_t first = band * tile_rows;
+    const size_t end = std :: min(first + tile_rows, m_rows);
+    // The ghost words of a row, from its own cells (columns wrap around unmirrored).
+    auto fill_sides = [n_words, last, top_bit, wraps](word_t* x){
+        x[-1] = wraps ? ((x[last] >> top_bit) & 1) << 63 : 0;
+        x[n_words] = wraps ? x[0] & 1 : 0;
+    };
+    auto now = [this, even](size_t r){ return even ? m_board.row(r) : m_board.next_row(r); };
+    auto next = [this, even](size_t r){ return even ? m_board.next_row(r) : m_board.row(r); };
+    bool changed = false;
+    for (size_t r = first; r < end; r++){
+        const word_t* x = now(r);
+        word_t* out = next(r);
+        (*m_step_row)(x - stride, x, x + stride, out, n_words, m_last_mask, top_bit, m_rule, m_run, nullptr);
+        fill_sides(out);
+        for (size_t w = 0; w < n_words; w++){
+            if (out[w] != x[w]){
+                changed = true;
+                m_stamps[band * grid_cols + w / tile_words] = m_epoch + gen + 1;
+                delta ^= word_key(r * n_words + w, x[w]) ^ word_key(r * n_words + w, out[w]);
+            }
+        }
+    }
+    if (!wraps){return changed;}
+    // The ghost row above the board stands for the last row, the one below for the first.
+    for (size_t r : {m_rows - 1, size_t(0)}){
+        if (r < first || r >= end){continue;}
+        const word_t* from = next(r);
+        word_t* ghost = (r == 0) ? next(m_rows) : next(0) - stride;
+        if (m_boundary == boundary_e :: TORUS){std :: copy(from - 1, from + n_words + 1, ghost - 1);}
+        else {
+            mirror_row(from, ghost, n_words, pad);
+            fill_sides(ghost);
+        }
+    }
+    return changed;
+};
+
+/**
+ * @brief Computes one tile of the next generation, if it is active.
+ * @param tile Index of the tile, in row-major order.
+ */
+void BitBoard :: step_tile(size_t tile){
+    if (!m_active[tile]){
+        m_changed[tile] = false;
+        return;
+    }
+    const size_t grid_cols = tile_grid_cols();
+    size_t r = tile / grid_cols * tile_rows;
+    size_t w = tile % grid_cols * tile_words;
+    m_deltas[tile] = 0;
+    m_changed[tile] = step_span(r, std :: min(r + tile_rows, m_rows), w, std :: min(w + tile_words, m_words), m_deltas[tile]);
+};
+
+/**
+ * @brief Computes the tiles of a range of tiles, in row-major order.
+ *
+ * With the adder kernel, each run of consecutive active tiles of a tile
+ * row is computed at once, so the vector kernels see long rows instead of
+ * one word per tile.
+ * @param begin First tile.
+ * @param end One past the last tile.
+ */
+void BitBoard :: step_tiles(size_t begin, size_t end){
+    if (m_kernel != kernel_e :: ADDER){
+        for (size_t tile = begin; tile < end; tile++){step_tile(tile);}
+        return;
+    }
+    const size_t grid_cols = tile_grid_cols();
+    size_t tile = begin;
+    while (tile < end){
+        if (!m_active[tile]){
+            m_changed[tile] = false;
+            tile++;
+            continue;
+        }
+        const size_t tile_row = tile / grid_cols;
+        const size_t row_end = std :: min(end, (tile_row + 1) * grid_cols);
+        size_t run_end = tile + 1;
+        while (run_end < row_end && m_active[run_end]){run_end++;}
+        (this->*m_run_tiles)(tile_row, tile % grid_cols, tile % grid_cols + (run_end - tile));
+        tile = run_end;
+    }
+};
+
+/**
+ * @brief Computes words of a row of the next generation with the adder kernel.
+ *
+ * Each word is combined with its west and east shifted copies (the
+ * neighbors at col - 1 and col + 1), for the row above, the row itself and
+ * the row below, and handed to adder_word(). The neighbors past the edges
+ * are read from the halo (see fill_halo()), so the inner loop has no
+ * wraparound branches and runs on vectors of words (see simd.h); only the
+ * last word of a row, whose east neighbor sits after the last column rather
+ * than after bit 63, is done apart. The result is written to the back buffer.
+ * @param r Row.
+ * @param word_begin First word to compute.
+ * @param word_end One past the last word to compute.
+ */
+template <class R>
+void BitBoard :: adder_row(size_t r, size_t word_begin, size_t word_end){
+    const uint16_t birth = R :: birth(m_rule);
+    const uint16_t survive = R :: survive(m_rule);
+    const size_t stride = m_board.stride();
+    const size_t last = m_words - 1;
+    const word_t* x = row(r);
+    word_t* out = m_board.next_row(r);
+    (*m_run)(x - stride, x, x + stride, out, word_begin, std :: min(word_end, last), birth, survive);
+    if (word_end == m_words){
+        // The ghost word after the row holds the cell east of the last column.
+        const unsigned top_bit = static_cast<unsigned>((m_cols - 1) % word_bits);
+        const word_t* rows[3] = {x - stride, x, x + stride};
+        word_t west[3], mid[3], east[3];
+        for (int k = 0; k < 3; k++){
+            const word_t* y = rows[k] + last;
+            mid[k] = y[0];
+            west[k] = (y[0] << 1) | (y[-1] >> 63);
+            east[k] = (y[0] >> 1) | ((y[1] & 1) << top_bit);
+        }
+        out[last] = adder_word<R>(birth, survive, west, mid, east) & m_last_mask;
+    }
+};
+
+/**
+ * @brief Computes a block of the next generation.
+ *
+ * The rows are computed by adder_row(); the rule is a template parameter,
+ * so each rule gets its own loop. Each row is then compared with the
+ * current one while still in cache, and the old and new keys of the words
+ * that change are XORed into delta, so the fingerprint needs no pass of
+ * its own.
+ * @param row_begin First row to compute.
+ * @param row_end One past the last row to compute.
+ * @param word_begin First word of each row to compute.
+ * @param word_end One past the last word of each row to compute.
+ * @param delta Receives the fingerprint change of the block.
+ * @return True if any cell of the block changed.
+ */
+template <class R>
+bool BitBoard :: step_span_adder(size_t row_begin, size_t row_end, size_t word_begin, size_t word_end, uint64_t& delta){
+    if (m_rows == 0 || m_words == 0){return false;}
+    const size_t n_words = m_words;
+    bool changed = false;
+    uint64_t hash = 0;
+    for (size_t r = row_begin; r < row_end; r++){
+        adder_row<R>(r, word_begin, word_end);
+        const word_t* x = row(r);
+        const word_t* out = m_board.next_row(r);
+        for (size_t w = word_begin; w < word_end; w++){
+            if (out[w] != x[w]){
+                changed = true;
+                hash ^= word_key(r * n_words + w, x[w]) ^ word_key(r * n_words + w, out[w]);
+            }
+        }
+    }
+    delta ^= hash;
+    return changed;
+};
+
+/**
+ * @brief Computes a run of active tiles of one tile row with the adder kernel.
+ *
+ * As step_span_adder() over the whole run, so the kernel gets rows as wide
+ * as the run to fill its vectors, but with the changes and the fingerprint
+ * deltas recorded tile by tile.
+ * @param tile_row Row of the tiles.
+ * @param tile_begin First tile column of the run.
+ * @param tile_end One past the last tile column of the run.
+ */
+template <class R>
+void BitBoard :: step_run_adder(size_t tile_row, size_t tile_begin, size_t tile_end){
+    const size_t n_words = m_words;
+    const size_t first = tile_row * tile_grid_cols();
+    const size_t word_begin = tile_begin * tile_words;
+    const size_t word_end = std :: min(tile_end * tile_words, n_words);
+    for (size_t tc = tile_begin; tc < tile_end; tc++){
+        m_changed[first + tc] = false;
+        m_deltas[first + tc] = 0;
+    }
+    for (size_t r = tile_row * tile_rows; r < std :: min((tile_row + 1) * tile_rows, m_rows); r++){
+        adder_row<R>(r, word_begin, word_end);
+        const word_t* x = row(r);
+        const word_t* out = m_board.next_row(r);
+        for (size_t w = word_begin; w < word_end; w++){
+            if (out[w] != x[w]){
+                const size_t tile = first + w / tile_words;
+                m_changed[tile] = true;
+                m_deltas[tile] ^= word_key(r * n_words + w, x[w]) ^ word_key(r * n_words + w, out[w]);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Computes one whole row of the next generation, for temporal blocking.
+ *
+ * As step_span_adder(), over every word of a row of a scratch board whose
+ * ghost words are filled, without fingerprint.
+ * @param above Row above.
+ * @param mid The row.
+ * @param below Row below.
+ * @param out Receives the next row.
+ * @param n_words # of words per row.
+ * @param last_mask Valid bits of the last word.
+ * @param top_bit Bit of the last column in the last word.
+ * @param rule Birth and survival conditions, unless R fixes them.
+ * @param run Adder kernel of the rule over the words before the last one.
+ * @param diff If not nullptr, the bits that change are ORed into it, word by word.
+ */
+template <class R>
+void BitBoard :: step_row(const word_t* above, const word_t* mid, const word_t* below, word_t* out, size_t n_words,
+                          word_t last_mask, unsigned top_bit, const Rule& rule, adder_run_t run, word_t* diff){
+    const uint16_t birth = R :: birth(rule);
+    const uint16_t survive = R :: survive(rule);
+    const word_t* rows[3] = {above, mid, below};
+    const size_t last = n_words - 1;
+    (*run)(above, mid, below, out, 0, last, birth, survive);
+    word_t west[3], here[3], east[3];
+    for (int k = 0; k < 3; k++){
+        const word_t* y = rows[k] + last;
+        here[k] = y[0];
+        west[k] = (y[0] << 1) | (y[-1] >> 63);
+        east[k] = (y[0] >> 1) | ((y[1] & 1) << top_bit);
+    }
+    out[last] = adder_word<R>(birth, survive, west, here, east) & last_mask;
+    if (diff != nullptr){
+        for (size_t w = 0; w < n_words; w++){diff[w] |= out[w] ^ mid[w];}
+    }
+};
+
+/**
+ * @brief Points the kernels at their instantiation for a rule.
+ */
+template <class R>
+void BitBoard :: select_rule(void){
+    m_span = &BitBoard :: step_span_adder<R>;
+    m_run_tiles = &BitBoard :: step_run_adder<R>;
+    m_run = adder_run_for<R>(m_simd);
+    m_step_row = &BitBoard :: step_row<R>;
+};
+
+/**
+ * @brief Selects the kernel that steps the tiles, once per rule or kernel change.
+ *
+ * The rules known at compile time get their own instantiation of the adder
+ * kernel; any other rule runs the generic one. The lookup-table kernels
+ * read the tables of the rule, built here unless it is Conway's.
+ */
+void BitBoard :: select_span(void){
+    auto is = [this](uint16_t birth, uint16_t survive){ return m_rule.birth == birth && m_rule.survive == survive; };
+    if (m_rule == Rule()){select_rule<Conway>();}
+    else if (is(HighLife :: birth(m_rule), HighLife :: survive(m_rule))){select_rule<HighLife>();}
+    else if (is(DayAndNight :: birth(m_rule), DayAndNight :: survive(m_rule))){select_rule<DayAndNight>();}
+    else if (is(Seeds :: birth(m_rule), Seeds :: survive(m_rule))){select_rule<Seeds>();}
+    else if (is(LifeWithoutDeath :: birth(m_rule), LifeWithoutDeath :: survive(m_rule))){select_rule<LifeWithoutDeath>();}
+    else {select_rule<AnyRule>();}
+    if (m_kernel == kernel_e :: LUT || m_kernel == kernel_e :: LUT16){
+        m_span = (m_kernel == kernel_e :: LUT) ? &BitBoard :: step_span_lut : &BitBoard :: step_span_lut16;
+        if (m_rule == Rule()){
+            m_lut3 = lut3x3.data();
+            m_lut4 = lut4x4.data();
+            return;
+        }
+        const auto table3 = make_lut3x3(m_rule.birth, m_rule.survive);
+        m_rule_lut3.assign(table3.begin(), table3.end());
+        m_lut3 = m_rule_lut3.data();
+        if (m_kernel == kernel_e :: LUT16){
+            const auto table4 = std :: make_unique<std :: array<uint8_t, 65536>>(make_lut4x4(m_rule.birth, m_rule.survive));
+            m_rule_lut4.assign(table4->begin(), table4->end());
+            m_lut4 = m_rule_lut4.data();
+        }
+    }
+};
+
+/**
+ * @brief Selects how the next states are computed.
+ * @param mode Kernel.
+ */
+void BitBoard :: kernel(kernel_e mode){
+    m_kernel = mode;
+    select_span();
+};
+
+/**
+ * @brief Caps the instruction set of the adder kernel.
+ *
+ * The kernel is compiled for plain words, SSE2, AVX2 and AVX-512; the
+ * widest one that is at most isa and that the CPU supports is used.
+ * @param isa Widest instruction set allowed.
+ */
+void BitBoard :: simd(simd_e isa){
+    m_simd = isa;
+    select_span();
+};
+
+/**
+ * @brief Returns the instruction set the adder kernel uses.
+ * @return The smaller of the cap and the widest one the CPU supports.
+ */
+simd_e BitBoard :: simd(void) const{
+    return static_cast<short>(m_simd) > static_cast<short>(simd_support()) ? simd_support() : m_simd;
+};
+
+/**
+ * @brief Selects how the edges of the board are glued together.
+ *
+ * Cells next to the edges get new neighbors, so every tile is computed in
+ * the next generation.
+ * @param mode Topology.
+ */
+void BitBoard :: boundary(boundary_e mode){
+    m_boundary = mode;
+    m_halo_stamp = m_epoch + 1;
+    std :: fill(m_stamps.begin(), m_stamps.end(), m_epoch + 1);
+};
+
+/**
+ * @brief Sets the birth and survival conditions.
+ * @param rule Rule.
+ */
+void BitBoard :: rule(const Rule& rule){
+    m_rule = rule;
+    select_span();
+};
+
+/**
+ * @brief Gathers a word of a row with the cells on each side of it.
+ *
+ * Returns the word with the padding past the last column replaced by the
+ * cell east of the last column, so every cell finds its east neighbor on its
+ * left, plus the cells just before bit 0 and just after bit 63. The cells
+ * past the edges come from the halo.
+ * @param x The word, in its row.
+ * @param is_last True if the word is the last one of its row.
+ * @param top_bit Bit of the last column in the last word.
+ * @param west Receives the cell before bit 0.
+ * @param east Receives the cell after bit 63.
+ * @return The word, extended.
+ */
+static inline BitBoard :: word_t gather(const BitBoard :: word_t* x, bool is_last, unsigned top_bit, BitBoard :: word_t& west, BitBoard :: word_t& east){
+    west = x[-1] >> 63;
+    if (is_last && top_bit < 63){
+        east = 0;
+        return x[0] | ((x[1] & 1) << (top_bit + 1));
+    }
+    east = x[1] & 1;
+    return x[0];
+}
+
+/**
+ * @brief Computes a block of the next generation, one table lookup per cell.
+ *
+ * The three cells above, at and below each cell form a 9-bit index into the
+ * table of the rule (lut3x3, for Conway's), so no neighbor is counted at
+ * run time. The
+ * window of bit j is bits j..j+2 of the 66-bit sequence (west, word, east).
+ * @param row_begin First row to compute.
+ * @param row_end One past the last row to compute.
+ * @param word_begin First word of each row to compute.
+ * @param word_end One past the last word of each row to compute.
+ * @param delta Receives the fingerprint change of the block.
+ * @return True if any cell of the block changed.
+ */
+bool BitBoard :: step_span_lut(size_t row_begin, size_t row_end, size_t word_begin, size_t word_end, uint64_t& delta){
+    if (m_rows == 0 || m_words == 0){return false;}
+    const size_t stride = m_board.stride();
+    const size_t n_words = m_words;
+    const size_t last = n_words - 1;
+    const word_t last_mask = m_last_mask;
+    const unsigned top_bit = static_cast<unsigned>((m_cols - 1) % word_bits);
+    const uint8_t* lut = m_lut3;
+    bool changed = false;
+    uint64_t hash = 0;
+
+    for (size_t r = row_begin; r < row_end; r++){
+        const word_t* y = row(r);
+        const word_t* rows[3] = {y - stride, y, y + stride};
+        word_t* out = m_board.next_row(r);
+        for (size_t w = word_begin; w < word_end; w++){
+            // lo holds the cells at col - 1 (bit j is the west neighbor of
+            // bit j), hi the two cells past the end of lo.
+            word_t lo[3], hi[3];
+            for (int k = 0; k < 3; k++){
+                word_t west, east;
+                word_t x = gather(rows[k] + w, w == last, top_bit, west, east);
+                lo[k] = (x << 1) | west;
+                hi[k] = (x >> 63) | (east << 1);
+            }
+            word_t alive = 0;
+            for (unsigned j = 0; j < 62; j++){
+                unsigned index = static_cast<unsigned>(((lo[0] >> j) & 7) | ((lo[1] >> j) & 7) << 3 | ((lo[2] >> j) & 7) << 6);
+                alive |= static_cast<word_t>(lut[index]) << j;
+            }
+            for (unsigned j = 62; j < 64; j++){
+                unsigned index = 0;
+                for (int k = 0; k < 3; k++){
+                    index |= static_cast<unsigned>(((lo[k] >> j) | (hi[k] << (64 - j))) & 7) << (3 * k);
+                }
+                alive |= static_cast<word_t>(lut[index]) << j;
+            }
+            if (w == last){alive &= last_mask;}
+            const word_t old = rows[1][w];
+            out[w] = alive;
+            if (alive != old){
+                changed = true;
+                hash ^= word_key(r * n_words + w, old) ^ word_key(r * n_words + w, alive);
+            }
+        }
+    }
+    delta ^= hash;
+    return changed;
+};
+
+/**
+ * @brief Computes a block of the next generation, one table lookup per 2x2 cells.
+ *
+ * Rows are computed in pairs: the 4x4 block around each pair of columns of
+ * a pair of rows is a 16-bit index into the table of the rule (lut4x4),
+ * which holds the four next states at once. A last unpaired row falls back
+ * to step_span_lut().
+ * @param row_begin First row to compute.
+ * @param row_end One past the last row to compute.
+ * @param word_begin First word of each row to compute.
+ * @param word_end One past the last word of each row to compute.
+ * @param delta Receives the fingerprint change of the block.
+ * @return True if any cell of the block changed.
+ */
+bool BitBoard :: step_span_lut16(size_t row_begin, size_t row_end, size_t word_begin, size_t word_end, uint64_t& delta){
+    if (m_rows == 0 || m_words == 0){return false;}
+    const size_t stride = m_board.stride();
+    const size_t n_words = m_words;
+    const size_t last = n_words - 1;
+    const word_t last_mask = m_last_mask;
+    const unsigned top_bit = static_cast<unsigned>((m_cols - 1) % word_bits);
+    const uint8_t* lut = m_lut4;
+    bool changed = false;
+    uint64_t hash = 0;
+
+    size_t r = row_begin;
+    for (; r + 1 < row_end; r += 2){
+        const word_t* y = row(r);
+        const word_t* rows[4] = {y - stride, y, y + stride, y + 2 * stride};
+        word_t* out[2] = {m_board.next_row(r), m_board.next_row(r + 1)};
+        for (size_t w = word_begin; w < word_end; w++){
+            word_t lo[4], hi[4];
+            for (int k = 0; k < 4; k++){
+                word_t west, east;
+                word_t x = gather(rows[k] + w, w == last, top_bit, west, east);
+                lo[k] = (x << 1) | west;
+                hi[k] = (x >> 63) | (east << 1);
+            }
+            word_t alive[2] = {0, 0};
+            for (unsigned j = 0; j < 64; j += 2){
+                unsigned index = 0;
+                for (int k = 0; k < 4; k++){
+                    word_t window = (j < 62) ? lo[k] >> j : (lo[k] >> j) | (hi[k] << 2);
+                    index |= static_cast<unsigned>(window & 15) << (4 * k);
+                }
+                const word_t next = lut[index];
+                alive[0] |= (next & 3) << j;
+                alive[1] |= (next >> 2) << j;
+            }
+            for (int k = 0; k < 2; k++){
+                if (w == last){alive[k] &= last_mask;}
+                const word_t old = rows[k + 1][w];
+                out[k][w] = alive[k];
+                if (alive[k] != old){
+                    changed = true;
+                    hash ^= word_key((r + k) * n_words + w, old) ^ word_key((r + k) * n_words + w, alive[k]);
+                }
+            }
+        }
+    }
+    delta ^= hash;
+    if (r < row_end){changed |= step_span_lut(r, row_end, word_begin, word_end, delta);}
+    return changed;
+};
+
+}  // namespace life
@@ -0,0 +1,241 @@
+//! This class implements a bit-packed life board.
+/*!
+ * @file bitboard.h
+ *
+ * @details Class BitBoard, a bounded grid that stores 64 cells per word
+ * and computes the next generation with word-parallel full-adder logic.
+ */
+
+#ifndef _BITBOARD_H_
+#define _BITBOARD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "board.h"
+#include "boundary.h"
+#include "engine.h"
+#include "rule.h"
+#include "simd.h"
+#include "thread_pool.h"
+#include "work_stealing.h"
+
+namespace life {
+
+/// A bounded board that packs 64 cells into each `uint64_t`.
+/*!
+ * Cell (row, col) is stored at bit `col % 64` of word `col / 64` of its row.
+ * Bits past the last column of a row are always kept at zero, so word-wide
+ * operations (population count, comparison) never see garbage. The words
+ * live in a double-buffered `Board`, so stepping allocates nothing.
+ *
+ * The halo of the board is refilled once per generation from the cells
+ * that its ghost cells stand for (see boundary.h; a torus by default), so
+ * the kernels read the neighbors past the edges like any other and the
+ * topology costs nothing inside them.
+ *
+ * The board is cut into 64x64 tiles. Each tile keeps the generation of its
+ * last change, and a generation only computes the tiles that changed, or
+ * touch a tile that changed, in the previous one: still-life debris and
+ * empty space cost nothing once they have settled.
+ *
+ * The fingerprint is kept up to date by the kernel itself, from the cells
+ * that flip, so it costs nothing where nothing changes either.
+ */
+class BitBoard : public Engine {
+    public:
+    typedef Board::word_t word_t;               //!< Storage word, 64 cells.
+    static constexpr size_t word_bits = 64;     //!< # of cells per word.
+    static constexpr size_t tile_rows = 64;     //!< # of rows of a tile.
+    static constexpr size_t tile_words = 1;     //!< # of words (64 cols each) of a tile.
+    static_assert(tile_rows == tile_words * word_bits, "tiles must be square");
+
+    /// How the generation is shared among the threads.
+    enum class schedule_e : short {
+        BANDS = 0,      //!< One static band of rows per thread.
+        TILES,          //!< Tiles on per-thread deques, with work stealing.
+        WAVEFRONT,      //!< Static bands of rows that advance as soon as their neighbors are done.
+    };
+
+    /// How the next state of the cells is computed.
+    enum class kernel_e : short {
+        ADDER = 0,      //!< Bitwise full adders, 64 cells at a time.
+        LUT,            //!< One 512-entry table lookup per cell (3x3 neighborhood).
+        LUT16,          //!< One 65536-entry table lookup per 2x2 block (4x4 neighborhood).
+    };
+
+    private:
+    size_t m_rows;                  //!< # of rows.
+    size_t m_cols;                  //!< # of columns.
+    size_t m_words;                 //!< # of words per row.
+    word_t m_last_mask;             //!< Valid bits of the last word of a row.
+    Board m_board;                  //!< Current and next generations.
+    schedule_e m_schedule;          //!< How threads share a generation.
+    kernel_e m_kernel;              //!< How the next states are computed.
+    boundary_e m_boundary;          //!< How the edges are glued together.
+    Rule m_rule;                    //!< Birth and survival conditions.
+    /// Kernel that computes a block, selected once per rule and kernel.
+    bool (BitBoard::*m_span)(size_t, size_t, size_t, size_t, uint64_t&);
+    /// Adder kernel over a run of tiles of a tile row, selected once per rule.
+    void (BitBoard::*m_run_tiles)(size_t, size_t, size_t);
+    simd_e m_simd;                  //!< Widest instruction set the adder kernel may use.
+    adder_run_t m_run;              //!< Adder kernel of the rule over a run of words, for m_simd.
+    const uint8_t* m_lut3;          //!< 3x3 table of the rule, for kernel_e::LUT.
+    const uint8_t* m_lut4;          //!< 4x4 table of the rule, for kernel_e::LUT16.
+    std::vector<uint8_t> m_rule_lut3;   //!< 3x3 table built for a rule other than Conway's.
+    std::vector<uint8_t> m_rule_lut4;   //!< 4x4 table built for a rule other than Conway's.
+    WorkStealing m_queues;          //!< Tile deques, for schedule_e::TILES.
+    ThreadPool* m_pool;             //!< Workers sharing a generation, or nullptr.
+    unsigned long long m_epoch;     //!< # of generations stepped.
+    std::vector<unsigned long long> m_stamps;   //!< Epoch of the last change of each tile.
+    std::vector<uint8_t> m_active;  //!< Tiles to compute in this generation.
+    std::vector<uint8_t> m_changed; //!< Tiles that changed in this generation.
+    std::vector<uint64_t> m_deltas; //!< Fingerprint change of each tile in this generation.
+    unsigned m_depth;               //!< # of generations per pass over the board (temporal blocking).
+    std::vector<Board> m_locals;    //!< Scratch band of each worker, for temporal blocking.
+    /// Adder kernel of the rule over a whole row, for temporal blocking.
+    void (*m_step_row)(const word_t*, const word_t*, const word_t*, word_t*, size_t, word_t, unsigned, const Rule&, adder_run_t, word_t*);
+    unsigned long long m_halo_stamp;    //!< Epoch until which the halo is refilled in full.
+    uint64_t m_hash;                //!< Fingerprint, updated as cells flip.
+
+    //!< Flags the tiles next to a change of the previous generation.
+    void mark_active(void);
+
+    //!< Fills the halo from the edges, and flags the edge tiles next to a change across them.
+    void fill_halo(void);
+
+    //!< Computes one tile, if active, and records whether it changed.
+    void step_tile(size_t tile);
+
+    //!< Computes the tiles of a range, runs of active tiles at once, and records which changed.
+    void step_tiles(size_t begin, size_t end);
+
+    //!< Computes words [word_begin, word_end) of a row of the next generation with the adder kernel.
+    template <class R>
+    void adder_row(size_t r, size_t word_begin, size_t word_end);
+
+    //!< The adder kernel over a run of tiles of a tile row, recording which of them changed.
+    template <class R>
+    void step_run_adder(size_t tile_row, size_t tile_begin, size_t tile_end);
+
+    //!< Points m_span at the kernel of the current rule and kernel mode.
+    void select_span(void);
+
+    //!< Points the kernels at their instantiation for a rule.
+    template <class R>
+    void select_rule(void);
+
+    //!< The adder kernel, specialized for a rule (see rule.h).
+    template <class R>
+    bool step_span_adder(size_t row_begin, size_t row_end, size_t word_begin, size_t word_end, uint64_t& delta);
+
+    //!< The adder kernel over a whole row of a scratch board, specialized for a rule.
+    template <class R>
+    static void step_row(const word_t* above, const word_t* mid, const word_t* below, word_t* out, size_t n_words,
+                         word_t last_mask, unsigned top_bit, const Rule& rule, adder_run_t run, word_t* diff);
+
+    //!< Advances the board several generations, band by band in cache.
+    void step_blocked(unsigned depth);
+
+    //!< Advances one band of tiles several generations in a scratch board.
+    void step_band(size_t band, unsigned depth, Board& local);
+
+    //!< Advances the board several generations, each band as soon as its neighbors are done.
+    void step_wavefront(unsigned long long generations);
+
+    //!< Computes one band of tiles of generation gen + 1 from the buffer holding generation gen.
+    bool step_wave_band(size_t band, unsigned long long gen, uint64_t& delta);
+
+    public:
+    BitBoard(size_t rows = 0, size_t cols = 0);
+
+    //!< Resizes the board and kills every cell.
+    void resize(size_t rows, size_t cols);
+
+    //!< Returns the # of rows.
+    size_t rows(void) const override { return m_rows; }
+
+    //!< Returns the # of columns.
+    size_t cols(void) const override { return m_cols; }
+
+    //!< Returns the # of words used by each row.
+    size_t words_per_row(void) const { return m_words; }
+
+    //!< Returns a pointer to the first word of a row.
+    const word_t* row(size_t r) const { return m_board.row(r); }
+
+    //!< Returns true if the cell is alive.
+    bool get(size_t row, size_t col) const override;
+
+    //!< Sets the state of a cell.
+    void set(size_t row, size_t col, bool alive) override;
+
+    //!< Sets every cell of a row, from words_per_row() words (in reverse order if mirrored).
+    void set_row(size_t r, const word_t* words, bool mirrored = false);
+
+    //!< Returns the # of alive cells.
+    unsigned long long population(void) const override;
+
+    //!< Advances the board by the given # of generations.
+    void step(unsigned long long generations) override;
+
+    //!< Advances the board one generation.
+    void step_once(void);
+
+    //!< Sets the # of generations advanced per pass over the board (1 to tile_rows).
+    void depth(unsigned generations);
+
+    //!< Computes a block of rows and words of the next generation, without swapping.
+    bool step_span(size_t row_begin, size_t row_end, size_t word_begin, size_t word_end, uint64_t& delta){
+        return (this->*m_span)(row_begin, row_end, word_begin, word_end, delta);
+    }
+
+    //!< As step_span(), with one table lookup per cell.
+    bool step_span_lut(size_t row_begin, size_t row_end, size_t word_begin, size_t word_end, uint64_t& delta);
+
+    //!< As step_span(), with one table lookup per 2x2 block of cells.
+    bool step_span_lut16(size_t row_begin, size_t row_end, size_t word_begin, size_t word_end, uint64_t& delta);
+
+    //!< Selects how the next states are computed.
+    void kernel(kernel_e mode);
+
+    //!< Caps the instruction set of the adder kernel (the widest the CPU supports by default).
+    void simd(simd_e isa);
+
+    //!< Returns the instruction set the adder kernel uses.
+    simd_e simd(void) const;
+
+    //!< Sets the birth and survival conditions.
+    void rule(const Rule& rule) override;
+
+    //!< Selects how the edges of the board are glued together.
+    void boundary(boundary_e mode);
+
+    //!< Selects how threads share a generation.
+    void schedule(schedule_e mode) { m_schedule = mode; }
+
+    //!< Sets the workers that share a generation (nullptr to step serially); set it before resize().
+    void pool(ThreadPool* pool) { m_pool = pool; }
+
+    //!< Backs the board with huge pages from the next resize() on.
+    void huge_pages(bool on) { m_board.huge_pages(on); }
+
+    //!< Returns the # of tile rows.
+    size_t tile_grid_rows(void) const { return (m_rows + tile_rows - 1) / tile_rows; }
+
+    //!< Returns the # of tile columns.
+    size_t tile_grid_cols(void) const { return (m_words + tile_words - 1) / tile_words; }
+
+    void read_tile(size_t tile_row, size_t tile_col, size_t side, uint64_t* out) const override;
+    uint64_t fingerprint(void) override { return m_hash; }
+    void snapshot(std::vector<uint64_t>& out) override;
+    size_t tile_size(void) const override { return tile_rows; }
+    unsigned long long epoch(void) const override { return m_epoch; }
+    unsigned long long tile_stamp(size_t tile_row, size_t tile_col) const override {
+        return m_stamps[tile_row * tile_grid_cols() + tile_col];
+    }
+};
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,143 @@
+/**
+ * Board class implementation.
+ *
+ */
+
+#include "board.h"
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace life {
+
+/**
+ * @brief Constructor for Board class.
+ * @param rows # of rows.
+ * @param words # of words per row.
+ */
+Board :: Board(size_t rows, size_t words) :
+    m_rows(0),
+    m_words(0),
+    m_stride(0),
+    m_block(nullptr),
+    m_front(nullptr),
+    m_back(nullptr),
+    m_huge(false)
+    {
+        resize(rows, words);
+    }
+
+/**
+ * @brief Destructor for Board class.
+ */
+Board :: ~Board(){
+    std :: free(m_block);
+};
+
+/**
+ * @brief Deep copy of a board, both buffers included.
+ * @param clone The board we are copying from.
+ */
+Board :: Board(const Board& clone) :
+    m_rows(0),
+    m_words(0),
+    m_stride(0),
+    m_block(nullptr),
+    m_front(nullptr),
+    m_back(nullptr),
+    m_huge(clone.m_huge)
+    {
+        *this = clone;
+    }
+
+/**
+ * @brief Deep assignment of a board, both buffers included.
+ * @param source The board we are copying from.
+ * @return A reference to the `this` object.
+ */
+Board& Board :: operator=(const Board& source){
+    if (this != &source){
+        resize(source.m_rows, source.m_words);
+        if (m_block != nullptr){
+            const size_t offset = alignment / sizeof(word_t) + m_stride;
+            const size_t buffer = offset + (m_rows + 1) * m_stride;
+            std :: memcpy(m_front - offset, source.m_front - offset, buffer * sizeof(word_t));
+            std :: memcpy(m_back - offset, source.m_back - offset, buffer * sizeof(word_t));
+        }
+    }
+    return *this;
+};
+
+/**
+ * @brief Reallocates the board. Both buffers start zeroed, halo included.
+ *
+ * With huge pages, a board that fills at least one is aligned to them and
+ * the kernel is asked to back it with them; it falls back to regular pages
+ * where it cannot.
+ * @param rows # of rows.
+ * @param words # of used words per row.
+ * @param zero False to leave the buffers to clear(), which must then cover every row.
+ */
+void Board :: resize(size_t rows, size_t words, bool zero){
+    const size_t line = alignment / sizeof(word_t);
+    std :: free(m_block);
+    m_rows = rows;
+    m_words = words;
+    // Room for the ghost words: the one after a row and the one before the
+    // next row share the padding at the end of the stride.
+    m_stride = (words + 2 + line - 1) / line * line;
+    m_block = m_front = m_back = nullptr;
+    if (m_rows == 0 || m_words == 0){return;}
+    // A cache line holding the ghost word before the ghost row above, the
+    // ghost rows, and the rows.
+    const size_t offset = line + m_stride;
+    const size_t buffer = offset + (m_rows + 1) * m_stride;
+    // The back buffer is shifted by a few cache lines: with power-of-two
+    // boards the two buffers would otherwise be a multiple of 4 KiB apart,
+    // and the row being written would alias the rows being read.
+    size_t gap = buffer_gap * line;
+    size_t bytes = (2 * buffer + gap) * sizeof(word_t);
+    const bool huge = m_huge && bytes >= huge_page;
+    if (huge){bytes = (bytes + huge_page - 1) / huge_page * huge_page;}
+    m_block = static_cast<word_t*>(std :: aligned_alloc(huge ? huge_page : alignment, bytes));
+    if (m_block == nullptr){throw std :: bad_alloc();}
+#ifdef MADV_HUGEPAGE
+    if (huge){madvise(m_block, bytes, MADV_HUGEPAGE);}
+#endif
+    m_front = m_block + offset;
+    m_back = m_block + buffer + gap + offset;
+    if (zero){clear(0, m_rows);}
+};
+
+/**
+ * @brief Zeroes a range of rows of both buffers.
+ *
+ * The halo above row 0 goes with row 0, and the ghost row below the last
+ * row with the last row, so ranges that cover every row clear the whole
+ * board.
+ * @param begin First row.
+ * @param end One past the last row.
+ */
+void Board :: clear(size_t begin, size_t end){
+    if (m_block == nullptr || begin >= end){return;}
+    const size_t offset = alignment / sizeof(word_t) + m_stride;
+    for (word_t* buffer : {m_front, m_back}){
+        word_t* from = (begin == 0) ? buffer - offset : buffer + begin * m_stride;
+        word_t* to = buffer + (end == m_rows ? end + 1 : end) * m_stride;
+        std :: fill(from, to, word_t(0));
+    }
+};
+
+/**
+ * @brief Swaps the current and the next generation buffers.
+ */
+void Board :: swap(void){
+    std :: swap(m_front, m_back);
+};
+
+}  // namespace life
@@ -0,0 +1,91 @@
+//! This class implements the storage of a life board.
+/*!
+ * @file board.h
+ *
+ * @details Class Board, a flat double-buffered grid of words with a halo.
+ */
+
+#ifndef _BOARD_H_
+#define _BOARD_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace life {
+
+/// Flat, cache-aligned, double-buffered storage for a grid of words.
+/*!
+ * Both generations live in a single allocation. Each row starts on a cache
+ * line (the row stride is padded to a multiple of `alignment` bytes) and
+ * rows follow each other without gaps, so a sweep over the board reads
+ * memory as one linear stream. The stepper reads the front buffer, writes
+ * the back buffer and calls `swap()`; no memory is allocated or copied
+ * between generations.
+ *
+ * Each buffer is surrounded by a one-word halo: every row has a ghost word
+ * before its first word (`row(r)[-1]`) and after its last one
+ * (`row(r)[words()]`), and there is a ghost row above the first row
+ * (`row(0) - stride()`) and below the last one (`row(rows())`). The stepper
+ * fills the halo of the front buffer before reading it, so neighbors past
+ * the edges are plain loads.
+ *
+ * Large boards may ask for 2 MiB pages (transparent huge pages, on Linux),
+ * so a sweep over the board needs far fewer TLB entries. The buffers can
+ * also be left untouched by `resize()` and zeroed band by band with
+ * `clear()`, by the threads that will step each band: the OS places a page
+ * on the NUMA node of the thread that touches it first.
+ */
+class Board {
+    public:
+    typedef uint64_t word_t;                    //!< Storage word.
+    static constexpr size_t alignment = 64;     //!< Row alignment, in bytes.
+    static constexpr size_t buffer_gap = 5;     //!< Cache lines between the two buffers.
+    static constexpr size_t huge_page = size_t(2) << 20;   //!< Size of a huge page, in bytes.
+
+    private:
+    size_t m_rows;          //!< # of rows.
+    size_t m_words;         //!< # of used words per row.
+    size_t m_stride;        //!< # of words between two rows (>= m_words).
+    word_t* m_block;        //!< The single allocation, holding both buffers.
+    word_t* m_front;        //!< Current generation.
+    word_t* m_back;         //!< Next generation, being written.
+    bool m_huge;            //!< Flag to back the board with huge pages.
+
+    public:
+    Board(size_t rows = 0, size_t words = 0);
+    ~Board();
+    Board(const Board&);
+    Board& operator=(const Board&);
+
+    //!< Reallocates the board and zeroes both buffers, unless told to leave them to clear().
+    void resize(size_t rows, size_t words, bool zero = true);
+
+    //!< Zeroes rows [begin, end) of both buffers, with the halo before row 0 and from row rows() on.
+    void clear(size_t begin, size_t end);
+
+    //!< Backs the board with huge pages from the next resize() on, if it fills one.
+    void huge_pages(bool on) { m_huge = on; }
+
+    //!< Returns the # of rows.
+    size_t rows(void) const { return m_rows; }
+
+    //!< Returns the # of used words per row.
+    size_t words(void) const { return m_words; }
+
+    //!< Returns the # of words between the start of two consecutive rows.
+    size_t stride(void) const { return m_stride; }
+
+    //!< Returns a row of the current generation (rows() is the ghost row below).
+    word_t* row(size_t r) { return m_front + r * m_stride; }
+    const word_t* row(size_t r) const { return m_front + r * m_stride; }
+
+    //!< Returns a row of the generation being computed.
+    word_t* next_row(size_t r) { return m_back + r * m_stride; }
+
+    //!< Makes the generation being computed the current one.
+    void swap(void);
+};
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,57 @@
+//! Topologies of the edges of a bounded board.
+/*!
+ * @file boundary.h
+ *
+ * @details How the cells just past the edges of a board (the halo) are
+ * filled: from the opposite edge, dead, or from the opposite edge mirrored.
+ */
+
+#ifndef _BOUNDARY_H_
+#define _BOUNDARY_H_
+
+#include <cstddef>
+
+namespace life {
+
+/// How the edges of a board are glued together.
+enum class boundary_e : short {
+    TORUS = 0,      //!< Both pairs of edges wrap around.
+    DEAD,           //!< Cells past the edges are always dead.
+    KLEIN,          //!< Columns wrap around; rows wrap around mirrored (Klein bottle).
+    CROSS,          //!< Both pairs of edges wrap around mirrored (cross-surface).
+};
+
+/// Finds the cell of the board that a cell of the halo stands for.
+/*!
+ * Mirrored edges reverse the cells along them, so the cell above (0, c) is
+ * (rows - 1, cols - 1 - c). The four corners of a cross-surface have no
+ * well defined neighbor past the corner, and are dead.
+ * @param mode Topology of the board.
+ * @param rows # of rows of the board.
+ * @param cols # of columns of the board.
+ * @param row Row of the cell, -1 to rows; receives the row on the board.
+ * @param col Column of the cell, -1 to cols; receives the column on the board.
+ * @return False if the cell is always dead.
+ */
+inline bool boundary_source(boundary_e mode, size_t rows, size_t cols, long long& row, long long& col){
+    const long long n_rows = static_cast<long long>(rows);
+    const long long n_cols = static_cast<long long>(cols);
+    const bool row_out = row < 0 || row >= n_rows;
+    const bool col_out = col < 0 || col >= n_cols;
+    if (!row_out && !col_out){return true;}
+    if (mode == boundary_e :: DEAD){return false;}
+    if (mode == boundary_e :: CROSS && row_out && col_out){return false;}
+    if (row_out){
+        row += (row < 0) ? n_rows : -n_rows;
+        if (mode != boundary_e :: TORUS){col = n_cols - 1 - col;}
+    }
+    if (col < 0 || col >= n_cols){
+        col += (col < 0) ? n_cols : -n_cols;
+        if (mode == boundary_e :: CROSS){row = n_rows - 1 - row;}
+    }
+    return true;
+}
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,51 @@
+/**
+ * Brent class implementation.
+ *
+ */
+
+#include "brent.h"
+
+namespace life {
+
+/**
+ * @brief Constructor for Brent class.
+ */
+Brent :: Brent() :
+    m_fingerprint(0),
+    m_snapshot(),
+    m_current(),
+    m_index(0),
+    m_power(1),
+    m_started(false)
+    {}
+
+/**
+ * @brief Compares a board with the tortoise, then moves the tortoise if due.
+ *
+ * Boards are snapshotted only when their fingerprint matches the tortoise's,
+ * or when they become the tortoise.
+ * @param table Current board.
+ * @param index Index of the board; boards must be fed in order.
+ * @param period Distance from the tortoise to the board, if they are equal.
+ * @return True if the board repeats the tortoise.
+ */
+bool Brent :: find(Engine& table, unsigned long long index, unsigned long long& period){
+    uint64_t fingerprint = table.fingerprint();
+    if (m_started && fingerprint == m_fingerprint){
+        table.snapshot(m_current);
+        if (m_current == m_snapshot){
+            period = index - m_index;
+            return true;
+        }
+    }
+    if (!m_started || index - m_index == m_power){
+        if (m_started){m_power *= 2;}
+        m_started = true;
+        m_fingerprint = fingerprint;
+        m_index = index;
+        table.snapshot(m_snapshot);
+    }
+    return false;
+};
+
+}  // namespace life
@@ -0,0 +1,46 @@
+//! This class implements constant-memory cycle detection.
+/*!
+ * @file brent.h
+ *
+ * @details Class Brent, used to detect that a simulation became stable
+ * without recording every past board.
+ */
+
+#ifndef _BRENT_H_
+#define _BRENT_H_
+
+#include <cstdint>
+#include <vector>
+#include "engine.h"
+
+namespace life {
+
+/// Brent's cycle detection over the boards of a simulation.
+/*!
+ * A single past board (the "tortoise") is kept. Each board is compared
+ * against it, and the tortoise jumps to the current board whenever the
+ * distance between them reaches the next power of two. Once the boards
+ * cycle, a match is found within two periods of the cycle start, so the
+ * memory stays flat at one snapshot at the cost of running a bit past it.
+ * The start of the cycle is not known at that point: it is found by
+ * replaying the simulation (see LifeCfg::cycle_start()).
+ */
+class Brent {
+    private:
+    uint64_t m_fingerprint;                 //!< Fingerprint of the tortoise.
+    std::vector<uint64_t> m_snapshot;       //!< The tortoise itself.
+    std::vector<uint64_t> m_current;        //!< Scratch snapshot of the current board.
+    unsigned long long m_index;             //!< Index of the tortoise.
+    unsigned long long m_power;             //!< Distance at which the tortoise jumps.
+    bool m_started;                         //!< Whether a tortoise was recorded.
+
+    public:
+    Brent();
+
+    //!< Feeds the index-th board; on a repetition, period receives its distance to the tortoise.
+    bool find(Engine& table, unsigned long long index, unsigned long long& period);
+};
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,290 @@
+/**
+ * ChunkedPlane class implementation.
+ *
+ */
+
+#include "chunked_plane.h"
+#include <algorithm>
+#include "adder.h"
+#include "zobrist.h"
+
+namespace life {
+
+/// Rows of a dead chunk, standing for the neighbors that are not allocated.
+static const std :: array<ChunkedPlane :: word_t, ChunkedPlane :: side> dead_chunk{};
+
+/**
+ * @brief Constructor for ChunkedPlane class. Every cell of the plane starts dead.
+ * @param rows # of rows of the window read from the input.
+ * @param cols # of columns of the window read from the input.
+ */
+ChunkedPlane :: ChunkedPlane(size_t rows, size_t cols) :
+    m_rows(rows),
+    m_cols(cols),
+    m_chunks(),
+    m_index(),
+    m_population(0),
+    m_hash(0),
+    m_rule(),
+    m_pool(nullptr),
+    m_step(&ChunkedPlane :: step_chunks<Conway>)
+    {}
+
+/**
+ * @brief Packs a pair of chunk coordinates into a key of the chunk index.
+ *
+ * Each coordinate keeps its low 32 bits, which covers 2^37 cells on
+ * either side of the origin.
+ * @param row Chunk row.
+ * @param col Chunk column.
+ * @return Key.
+ */
+uint64_t ChunkedPlane :: key(long long row, long long col){
+    return (static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32) | static_cast<uint32_t>(col);
+};
+
+/**
+ * @brief Returns the fingerprint key of a row of a chunk.
+ * @param chunk Chunk.
+ * @param row Row of the chunk.
+ * @param word Cells of the row.
+ * @return word_key() of the word, indexed by its plane row and chunk column.
+ */
+uint64_t ChunkedPlane :: row_key(const Chunk& chunk, size_t row, word_t word){
+    const uint64_t plane_row = static_cast<uint64_t>(chunk.row) * side + row;
+    return word_key((plane_row << 32) ^ static_cast<uint32_t>(chunk.col), word);
+};
+
+/**
+ * @brief Looks up a chunk.
+ * @param row Chunk row.
+ * @param col Chunk column.
+ * @return The chunk, or nullptr if it is not allocated.
+ */
+ChunkedPlane :: Chunk* ChunkedPlane :: find(long long row, long long col) const{
+    auto found = m_index.find(key(row, col));
+    return (found == m_index.end()) ? nullptr : found->second;
+};
+
+/**
+ * @brief Looks up a chunk, allocating it dead if it is not there yet.
+ * @param row Chunk row.
+ * @param col Chunk column.
+ * @return The chunk.
+ */
+ChunkedPlane :: Chunk* ChunkedPlane :: chunk(long long row, long long col){
+    Chunk*& slot = m_index[key(row, col)];
+    if (slot == nullptr){
+        m_chunks.emplace_back(new Chunk());
+        slot = m_chunks.back().get();
+        slot->row = row;
+        slot->col = col;
+        slot->cells.fill(0);
+    }
+    return slot;
+};
+
+/**
+ * @brief Returns the state of a cell of the window.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @return True if the cell is alive.
+ */
+bool ChunkedPlane :: get(size_t row, size_t col) const{
+    const Chunk* c = find(static_cast<long long>(row / side), static_cast<long long>(col / side));
+    if (c == nullptr){return false;}
+    return (c->cells[row % side] >> (col % side)) & 1;
+};
+
+/**
+ * @brief Sets the state of a cell of the window.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @param alive New state of the cell.
+ */
+void ChunkedPlane :: set(size_t row, size_t col, bool alive){
+    Chunk* c = chunk(static_cast<long long>(row / side), static_cast<long long>(col / side));
+    const word_t bit = word_t(1) << (col % side);
+    word_t& word = c->cells[row % side];
+    if (static_cast<bool>(word & bit) == alive){return;}
+    m_hash ^= row_key(*c, row % side, word) ^ row_key(*c, row % side, word ^ bit);
+    word ^= bit;
+    if (alive){m_population++;}
+    else {m_population--;}
+};
+
+/**
+ * @brief Prepares the chunks for a generation.
+ *
+ * A dead cell can only be born next to an alive one, so a missing chunk is
+ * allocated when the facing edge (or corner) of a neighbor has an alive cell.
+ * Then every chunk gets the rows of its eight neighbors, or of a dead chunk.
+ */
+void ChunkedPlane :: grow(void){
+    const size_t n = m_chunks.size();
+    for (size_t i = 0; i < n; i++){
+        // A chunk allocated here may move the pointers of m_chunks, never the chunks.
+        const Chunk& c = *m_chunks[i];
+        const word_t top = c.cells[0];
+        const word_t bottom = c.cells[side - 1];
+        word_t west = 0, east = 0;
+        for (size_t r = 0; r < side; r++){
+            west |= c.cells[r];
+            east |= c.cells[r];
+        }
+        west &= 1;
+        east >>= side - 1;
+        if (top != 0){chunk(c.row - 1, c.col);}
+        if (bottom != 0){chunk(c.row + 1, c.col);}
+        if (west != 0){chunk(c.row, c.col - 1);}
+        if (east != 0){chunk(c.row, c.col + 1);}
+        if (top & 1){chunk(c.row - 1, c.col - 1);}
+        if (top >> (side - 1)){chunk(c.row - 1, c.col + 1);}
+        if (bottom & 1){chunk(c.row + 1, c.col - 1);}
+        if (bottom >> (side - 1)){chunk(c.row + 1, c.col + 1);}
+    }
+    static const long long d_row[AROUND] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    static const long long d_col[AROUND] = {0, 0, -1, 1, -1, 1, -1, 1};
+    for (auto& c : m_chunks){
+        for (unsigned d = 0; d < AROUND; d++){
+            const Chunk* other = find(c->row + d_row[d], c->col + d_col[d]);
+            c->around[d] = (other == nullptr) ? dead_chunk.data() : other->cells.data();
+        }
+    }
+};
+
+/**
+ * @brief Computes the next rows of a run of chunks.
+ *
+ * The rows of a chunk, and the edge rows of its north and south neighbors,
+ * are shifted one cell west and east with the edge columns of the
+ * neighbors shifted in, and handed to adder_word() three rows at a time.
+ * The rule is a template parameter, so each rule gets its own loop.
+ * @param begin First chunk.
+ * @param end One past the last chunk.
+ * @param delta XOR-ed with the change of the fingerprint.
+ * @param population Increased by the # of alive cells of the next rows.
+ */
+template <class R>
+void ChunkedPlane :: step_chunks(size_t begin, size_t end, uint64_t& delta, unsigned long long& population){
+    const uint16_t birth = R :: birth(m_rule);
+    const uint16_t survive = R :: survive(m_rule);
+    // Row r of the chunk is at r + 1; rows 0 and side + 1 belong to the north and south neighbors.
+    word_t west[side + 2], here[side + 2], east[side + 2];
+    auto load = [&west, &here, &east](size_t at, word_t word, word_t before, word_t after){
+        here[at] = word;
+        west[at] = (word << 1) | (before >> (side - 1));
+        east[at] = (word >> 1) | (after << (side - 1));
+    };
+    for (size_t i = begin; i < end; i++){
+        Chunk& c = *m_chunks[i];
+        const word_t* const* around = c.around;
+        load(0, around[NORTH][side - 1], around[NORTH_WEST][side - 1], around[NORTH_EAST][side - 1]);
+        for (size_t r = 0; r < side; r++){load(r + 1, c.cells[r], around[WEST][r], around[EAST][r]);}
+        load(side + 1, around[SOUTH][0], around[SOUTH_WEST][0], around[SOUTH_EAST][0]);
+        word_t any = 0;
+        for (size_t r = 0; r < side; r++){
+            const word_t next = adder_word<R>(birth, survive, west + r, here + r, east + r);
+            c.next[r] = next;
+            any |= next;
+            population += __builtin_popcountll(next);
+            if (next != c.cells[r]){delta ^= row_key(c, r, c.cells[r]) ^ row_key(c, r, next);}
+        }
+        c.alive = any != 0;
+    }
+};
+
+/**
+ * @brief Advances the plane one generation.
+ *
+ * The chunks are stepped in equal shares by the workers of the pool, each
+ * one adding up the changes of the fingerprint and population of its share.
+ * The chunks left empty are then freed.
+ */
+void ChunkedPlane :: step_once(void){
+    grow();
+    const size_t n = m_chunks.size();
+    uint64_t delta = 0;
+    unsigned long long population = 0;
+    if (m_pool == nullptr || n < m_pool->size()){(this->*m_step)(0, n, delta, population);}
+    else {
+        const size_t workers = m_pool->size();
+        std :: vector<uint64_t> deltas(workers, 0);
+        std :: vector<unsigned long long> populations(workers, 0);
+        m_pool->run([this, n, workers, &deltas, &populations](size_t worker){
+            (this->*m_step)(worker * n / workers, (worker + 1) * n / workers, deltas[worker], populations[worker]);
+        });
+        for (size_t w = 0; w < workers; w++){
+            delta ^= deltas[w];
+            population += populations[w];
+        }
+    }
+    m_hash ^= delta;
+    m_population = population;
+    size_t kept = 0;
+    for (size_t i = 0; i < n; i++){
+        Chunk& c = *m_chunks[i];
+        if (!c.alive){
+            m_index.erase(key(c.row, c.col));
+            m_chunks[i].reset();
+            continue;
+        }
+        c.cells = c.next;
+        if (kept != i){m_chunks[kept] = std :: move(m_chunks[i]);}
+        kept++;
+    }
+    m_chunks.resize(kept);
+};
+
+/**
+ * @brief Sets the birth and survival conditions.
+ *
+ * The rules known at compile time get their own instantiation of the
+ * kernel; any other rule runs the generic one.
+ * @param rule Rule.
+ */
+void ChunkedPlane :: rule(const Rule& rule){
+    m_rule = rule;
+    auto is = [this](uint16_t birth, uint16_t survive){ return m_rule.birth == birth && m_rule.survive == survive; };
+    if (m_rule == Rule()){m_step = &ChunkedPlane :: step_chunks<Conway>;}
+    else if (is(HighLife :: birth(m_rule), HighLife :: survive(m_rule))){m_step = &ChunkedPlane :: step_chunks<HighLife>;}
+    else if (is(DayAndNight :: birth(m_rule), DayAndNight :: survive(m_rule))){m_step = &ChunkedPlane :: step_chunks<DayAndNight>;}
+    else if (is(Seeds :: birth(m_rule), Seeds :: survive(m_rule))){m_step = &ChunkedPlane :: step_chunks<Seeds>;}
+    else if (is(LifeWithoutDeath :: birth(m_rule), LifeWithoutDeath :: survive(m_rule))){m_step = &ChunkedPlane :: step_chunks<LifeWithoutDeath>;}
+    else {m_step = &ChunkedPlane :: step_chunks<AnyRule>;}
+};
+
+/**
+ * @brief Advances the plane by several generations.
+ * @param generations # of generations.
+ */
+void ChunkedPlane :: step(unsigned long long generations){
+    for (unsigned long long i = 0; i < generations; i++){step_once();}
+};
+
+/**
+ * @brief Writes the alive chunks of the whole plane.
+ *
+ * Each chunk with an alive cell is written as its chunk row and column and
+ * its 64 rows, in order of chunk row and column, so two planes are equal
+ * exactly when their snapshots are.
+ * @param out Receives 2 + 64 words per chunk.
+ */
+void ChunkedPlane :: snapshot(std :: vector<uint64_t>& out){
+    std :: vector<const Chunk*> alive;
+    for (const auto& c : m_chunks){
+        if (std :: any_of(c->cells.begin(), c->cells.end(), [](word_t word){ return word != 0; })){alive.push_back(c.get());}
+    }
+    std :: sort(alive.begin(), alive.end(), [](const Chunk* a, const Chunk* b){
+        return a->row != b->row ? a->row < b->row : a->col < b->col;
+    });
+    out.clear();
+    out.reserve(alive.size() * (side + 2));
+    for (const Chunk* c : alive){
+        out.push_back(static_cast<uint64_t>(c->row));
+        out.push_back(static_cast<uint64_t>(c->col));
+        out.insert(out.end(), c->cells.begin(), c->cells.end());
+    }
+};
+
+}  // namespace life
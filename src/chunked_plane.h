@@ -0,0 +1,116 @@
+//! This class implements a sparse engine over the unbounded plane.
+/*!
+ * @file chunked_plane.h
+ *
+ * @details Class ChunkedPlane, the infinite plane cut into 64x64 chunks,
+ * of which only those with alive cells are kept.
+ */
+
+#ifndef _CHUNKED_PLANE_H_
+#define _CHUNKED_PLANE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "engine.h"
+#include "thread_pool.h"
+
+namespace life {
+
+/// The unbounded plane, stored as a hash map of 64x64 chunks.
+/*!
+ * A chunk is 64 words, one per row, 64 cells each, at chunk coordinates
+ * (row / 64, col / 64) of the plane; the window read from the input file is
+ * the region of the plane with row and col from 0. A chunk is allocated the
+ * first time one of its cells could be born, that is when a cell on the
+ * facing edge of a neighbor is alive, and freed once a generation leaves
+ * it empty, so the memory follows the pattern and not the space it has
+ * crossed. Nothing wraps around: gliders fly away and guns never hit their
+ * own stream.
+ *
+ * Each chunk is stepped by the adder kernel of BitBoard (see adder.h), with
+ * the edge words of its eight neighbors as ghost cells; absent neighbors are
+ * dead. The chunks of a generation are shared out among the threads of a
+ * pool, if one is given. The fingerprint is the XOR of word_key() of every
+ * word, indexed by its plane row and chunk column, and is updated from the
+ * words that change.
+ */
+class ChunkedPlane : public Engine {
+    public:
+    typedef uint64_t word_t;                    //!< 64 cells of a chunk row.
+    static constexpr size_t side = 64;          //!< # of rows and columns of a chunk.
+
+    private:
+    /// Neighbors of a chunk.
+    enum around_e : unsigned {
+        NORTH = 0, SOUTH, WEST, EAST, NORTH_WEST, NORTH_EAST, SOUTH_WEST, SOUTH_EAST, AROUND
+    };
+
+    /// 64x64 cells of the plane.
+    struct Chunk {
+        long long row;                          //!< Chunk row, plane row / 64.
+        long long col;                          //!< Chunk column, plane column / 64.
+        std::array<word_t, side> cells;         //!< Current rows.
+        std::array<word_t, side> next;          //!< Rows of the next generation.
+        const word_t* around[AROUND];           //!< Rows of each neighbor, or of a dead chunk.
+        bool alive;                             //!< Flag telling that the next rows have an alive cell.
+    };
+
+    size_t m_rows;                                          //!< # of rows of the window.
+    size_t m_cols;                                          //!< # of columns of the window.
+    std::vector<std::unique_ptr<Chunk>> m_chunks;           //!< Allocated chunks.
+    std::unordered_map<uint64_t, Chunk*> m_index;           //!< Chunk at each pair of chunk coordinates.
+    unsigned long long m_population;                        //!< # of alive cells.
+    uint64_t m_hash;                                        //!< Fingerprint, updated as words change.
+    Rule m_rule;                                            //!< Birth and survival conditions.
+    ThreadPool* m_pool;                                     //!< Workers sharing a generation, or nullptr.
+    void (ChunkedPlane::*m_step)(size_t, size_t, uint64_t&, unsigned long long&);    //!< Kernel of the rule.
+
+    //!< Returns the key of a pair of chunk coordinates in m_index.
+    static uint64_t key(long long row, long long col);
+
+    //!< Returns the fingerprint key of a row of a chunk.
+    static uint64_t row_key(const Chunk& chunk, size_t row, word_t word);
+
+    //!< Returns the chunk at a pair of chunk coordinates, or nullptr.
+    Chunk* find(long long row, long long col) const;
+
+    //!< Returns the chunk at a pair of chunk coordinates, allocated if needed.
+    Chunk* chunk(long long row, long long col);
+
+    //!< Allocates the dead neighbors where a cell may be born, and links every chunk to its neighbors.
+    void grow(void);
+
+    //!< Computes the next rows of chunks [begin, end), with the kernel of rule R.
+    template <class R>
+    void step_chunks(size_t begin, size_t end, uint64_t& delta, unsigned long long& population);
+
+    //!< Advances the plane one generation.
+    void step_once(void);
+
+    public:
+    ChunkedPlane(size_t rows, size_t cols);
+
+    //!< Sets the workers that share each generation (nullptr: the calling thread alone).
+    void pool(ThreadPool* pool) { m_pool = pool; }
+
+    //!< Returns the # of chunks allocated.
+    size_t chunks(void) const { return m_chunks.size(); }
+
+    size_t rows(void) const override { return m_rows; }
+    size_t cols(void) const override { return m_cols; }
+    bool get(size_t row, size_t col) const override;
+    void set(size_t row, size_t col, bool alive) override;
+    unsigned long long population(void) const override { return m_population; }
+    void step(unsigned long long generations) override;
+    void rule(const Rule& rule) override;
+    uint64_t fingerprint(void) override { return m_hash; }
+    void snapshot(std::vector<uint64_t>& out) override;
+};
+
+}  // namespace life
+
+#endif
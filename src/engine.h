@@ -0,0 +1,83 @@
+//! This class defines the interface of a life simulation engine.
+/*!
+ * @file engine.h
+ *
+ * @details Class Engine, implemented by every way of stepping a board.
+ */
+
+#ifndef _ENGINE_H_
+#define _ENGINE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "rule.h"
+
+namespace life {
+
+/// A life board together with the algorithm that advances it.
+/*!
+ * Cells are addressed inside a `rows() x cols()` window. For the bounded
+ * engines the window is the whole board; unbounded engines simulate the
+ * infinite plane and the window is the region read from the input file.
+ */
+class Engine {
+    public:
+    virtual ~Engine() = default;
+
+    //!< Returns the # of rows of the window.
+    virtual size_t rows(void) const = 0;
+
+    //!< Returns the # of columns of the window.
+    virtual size_t cols(void) const = 0;
+
+    //!< Returns true if the cell is alive.
+    virtual bool get(size_t row, size_t col) const = 0;
+
+    //!< Sets the state of a cell.
+    virtual void set(size_t row, size_t col, bool alive) = 0;
+
+    //!< Returns the # of alive cells (on the whole plane, for unbounded engines).
+    virtual unsigned long long population(void) const = 0;
+
+    //!< Advances the board by the given # of generations.
+    virtual void step(unsigned long long generations) = 0;
+
+    //!< Sets the birth and survival conditions (Conway's B3/S23 by default).
+    virtual void rule(const Rule& rule) = 0;
+
+    //!< Returns the side of the square tiles whose changes are tracked (0: untracked).
+    virtual size_t tile_size(void) const { return 0; }
+
+    //!< Returns the # of generations stepped so far, the clock of the tile stamps.
+    virtual unsigned long long epoch(void) const { return 0; }
+
+    //!< Returns the epoch of the last change of a tile (changes after the last step are newer than epoch()).
+    virtual unsigned long long tile_stamp(size_t, size_t) const { return 0; }
+
+    //!< Copies a side x side block of cells (side a multiple of 64), 64 per word, row after row; cells past the window are dead.
+    virtual void read_tile(size_t tile_row, size_t tile_col, size_t side, uint64_t* out) const {
+        const size_t words = side / 64;
+        for (size_t i = 0; i < side; i++){
+            for (size_t w = 0; w < words; w++){
+                uint64_t bits = 0;
+                for (size_t b = 0; b < 64; b++){
+                    size_t r = tile_row * side + i;
+                    size_t c = tile_col * side + w * 64 + b;
+                    if (r < rows() && c < cols() && get(r, c)){bits |= uint64_t(1) << b;}
+                }
+                out[i * words + w] = bits;
+            }
+        }
+    }
+
+    //!< Returns a 64-bit fingerprint of the whole board (of the whole plane, for unbounded engines).
+    virtual uint64_t fingerprint(void) = 0;
+
+    //!< Writes an exact, compact copy of the whole board, to confirm fingerprint matches.
+    virtual void snapshot(std::vector<uint64_t>& out) = 0;
+};
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,424 @@
+/**
+ * HashLife class implementation.
+ *
+ */
+
+#include "hashlife.h"
+#include <algorithm>
+
+namespace life {
+
+/**
+ * @brief Hashes the four quadrants of a node.
+ * @param k Quadrants.
+ * @return Hash value.
+ */
+size_t HashLife :: KeyHash :: operator()(const Key& k) const{
+    uint64_t h = k.nw;
+    h = h * 0x9e3779b97f4a7c15ULL + k.ne;
+    h = h * 0x9e3779b97f4a7c15ULL + k.sw;
+    h = h * 0x9e3779b97f4a7c15ULL + k.se;
+    return static_cast<size_t>(h ^ (h >> 29));
+};
+
+/**
+ * @brief Constructor for HashLife class.
+ * @param rows # of rows of the window read from the input.
+ * @param cols # of columns of the window read from the input.
+ */
+HashLife :: HashLife(size_t rows, size_t cols) :
+    m_rows(rows),
+    m_cols(cols),
+    m_nodes(),
+    m_index(),
+    m_results(),
+    m_empty(),
+    m_root(0),
+    m_rule()
+    {
+        m_nodes.push_back(Node{0, 0, 0, 0, 0, 0x2545f4914f6cdd1dULL, 0});  // Dead cell.
+        m_nodes.push_back(Node{0, 0, 0, 0, 1, 0x9e3779b97f4a7c15ULL, 0});  // Alive cell.
+        m_root = empty(3);
+    }
+
+/**
+ * @brief Returns the canonical node made of four quadrants.
+ * @param nw North-west quadrant.
+ * @param ne North-east quadrant.
+ * @param sw South-west quadrant.
+ * @param se South-east quadrant.
+ * @return The node, created if it did not exist yet.
+ */
+HashLife :: node_t HashLife :: join(node_t nw, node_t ne, node_t sw, node_t se){
+    Key key{nw, ne, sw, se};
+    auto found = m_index.find(key);
+    if (found != m_index.end()){return found->second;}
+    unsigned long long pop = m_nodes[nw].pop + m_nodes[ne].pop + m_nodes[sw].pop + m_nodes[se].pop;
+    uint64_t hash = m_nodes[nw].level + 1;
+    for (node_t q : {nw, ne, sw, se}){
+        hash = (hash ^ m_nodes[q].hash) * 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 32;
+    }
+    node_t id = static_cast<node_t>(m_nodes.size());
+    m_nodes.push_back(Node{nw, ne, sw, se, pop, hash, m_nodes[nw].level + 1});
+    m_index.emplace(key, id);
+    return id;
+};
+
+/**
+ * @brief Returns the node of a level with every cell dead.
+ * @param level Level of the node.
+ * @return The empty node.
+ */
+HashLife :: node_t HashLife :: empty(unsigned level){
+    if (m_empty.empty()){m_empty.push_back(0);}
+    while (m_empty.size() <= level){
+        node_t e = m_empty.back();
+        m_empty.push_back(join(e, e, e, e));
+    }
+    return m_empty[level];
+};
+
+/**
+ * @brief Surrounds a node with a dead border, keeping its center.
+ * @param n Node of level L.
+ * @return Node of level L + 1.
+ */
+HashLife :: node_t HashLife :: expand(node_t n){
+    Node a = m_nodes[n];
+    node_t e = empty(a.level - 1);
+    return join(join(e, e, e, a.nw), join(e, e, a.ne, e),
+                join(e, a.sw, e, e), join(a.se, e, e, e));
+};
+
+/**
+ * @brief Returns the central square of a node, one level down.
+ * @param n Node of level L >= 2.
+ * @return Node of level L - 1.
+ */
+HashLife :: node_t HashLife :: centre(node_t n){
+    Node a = m_nodes[n];
+    return join(m_nodes[a.nw].se, m_nodes[a.ne].sw, m_nodes[a.sw].ne, m_nodes[a.se].nw);
+};
+
+/**
+ * @brief Returns the square centered on the border of two side by side nodes.
+ * @param w West node.
+ * @param e East node.
+ * @return Node of the same level.
+ */
+HashLife :: node_t HashLife :: centre_h(node_t w, node_t e){
+    Node a = m_nodes[w];
+    Node b = m_nodes[e];
+    return join(a.ne, b.nw, a.se, b.sw);
+};
+
+/**
+ * @brief Returns the square centered on the border of two stacked nodes.
+ * @param n North node.
+ * @param s South node.
+ * @return Node of the same level.
+ */
+HashLife :: node_t HashLife :: centre_v(node_t n, node_t s){
+    Node a = m_nodes[n];
+    Node b = m_nodes[s];
+    return join(a.sw, a.se, b.nw, b.ne);
+};
+
+/**
+ * @brief Computes the 2x2 center of a 4x4 node after one generation.
+ * @param n Node of level 2.
+ * @return Node of level 1.
+ */
+HashLife :: node_t HashLife :: base_step(node_t n){
+    Node a = m_nodes[n];
+    const node_t quads[4] = {a.nw, a.ne, a.sw, a.se};
+    int cells[4][4];
+    for (int q = 0; q < 4; q++){
+        Node b = m_nodes[quads[q]];
+        int y = (q / 2) * 2;
+        int x = (q % 2) * 2;
+        cells[y][x] = static_cast<int>(b.nw);
+        cells[y][x + 1] = static_cast<int>(b.ne);
+        cells[y + 1][x] = static_cast<int>(b.sw);
+        cells[y + 1][x + 1] = static_cast<int>(b.se);
+    }
+    node_t next[4];
+    for (int k = 0; k < 4; k++){
+        int y = 1 + k / 2;
+        int x = 1 + k % 2;
+        int n_alives = 0;
+        for (int dy = -1; dy <= 1; dy++){
+            for (int dx = -1; dx <= 1; dx++){
+                if (dy != 0 || dx != 0){n_alives += cells[y + dy][x + dx];}
+            }
+        }
+        bool alive = m_rule.next(cells[y][x] == 1, static_cast<unsigned>(n_alives));
+        next[k] = alive ? 1 : 0;
+    }
+    return join(next[0], next[1], next[2], next[3]);
+};
+
+/**
+ * @brief Advances the center of a node by 2^j generations.
+ *
+ * The node is cut into nine overlapping squares one level down. For the full
+ * step (j = L - 2) each square is advanced by 2^(L-3) generations, the nine
+ * results are regrouped into four squares and advanced again by 2^(L-3).
+ * For shorter steps the first stage only takes the centers (no time passes)
+ * and the second stage advances by 2^j. Every result is memoized.
+ * @param n Node of level L >= 2.
+ * @param j log2 of the # of generations, j <= L - 2.
+ * @return Node of level L - 1, centered like `n`.
+ */
+HashLife :: node_t HashLife :: successor(node_t n, unsigned j){
+    Node a = m_nodes[n];
+    if (a.pop == 0){return empty(a.level - 1);}
+    uint64_t key = (static_cast<uint64_t>(n) << 6) | j;
+    auto found = m_results.find(key);
+    if (found != m_results.end()){return found->second;}
+
+    node_t result;
+    if (a.level == 2){
+        result = base_step(n);
+    }
+    else {
+        node_t sq[9] = {
+            a.nw, centre_h(a.nw, a.ne), a.ne,
+            centre_v(a.nw, a.sw), centre(n), centre_v(a.ne, a.se),
+            a.sw, centre_h(a.sw, a.se), a.se,
+        };
+        const bool full = (j == a.level - 2);
+        const unsigned sub = full ? a.level - 3 : j;
+        for (int i = 0; i < 9; i++){
+            sq[i] = full ? successor(sq[i], sub) : centre(sq[i]);
+        }
+        node_t q_nw = join(sq[0], sq[1], sq[3], sq[4]);
+        node_t q_ne = join(sq[1], sq[2], sq[4], sq[5]);
+        node_t q_sw = join(sq[3], sq[4], sq[6], sq[7]);
+        node_t q_se = join(sq[4], sq[5], sq[7], sq[8]);
+        result = join(successor(q_nw, sub), successor(q_ne, sub),
+                      successor(q_sw, sub), successor(q_se, sub));
+    }
+    m_results.emplace(key, result);
+    return result;
+};
+
+/**
+ * @brief Checks that the pattern fits in the central quarter of a node.
+ * @param n Node of level >= 3.
+ * @return True if no alive cell lies outside the central quarter.
+ */
+bool HashLife :: centred(node_t n) const{
+    const Node& a = m_nodes[n];
+    unsigned long long inner = m_nodes[m_nodes[m_nodes[a.nw].se].se].pop
+                             + m_nodes[m_nodes[m_nodes[a.ne].sw].sw].pop
+                             + m_nodes[m_nodes[m_nodes[a.sw].ne].ne].pop
+                             + m_nodes[m_nodes[m_nodes[a.se].nw].nw].pop;
+    return inner == a.pop;
+};
+
+/**
+ * @brief Advances the whole pattern by 2^j generations.
+ *
+ * The root is grown until it is at least of level j + 3 and the pattern sits
+ * in its central quarter. The pattern then cannot travel out of the center
+ * half, which is exactly what `successor()` returns.
+ * @param j log2 of the # of generations.
+ */
+void HashLife :: advance(unsigned j){
+    while (m_nodes[m_root].level < j + 3 || !centred(m_root)){
+        m_root = expand(m_root);
+    }
+    m_root = successor(m_root, j);
+};
+
+/**
+ * @brief Advances the pattern, one power of two at a time.
+ * @param generations # of generations.
+ */
+void HashLife :: step(unsigned long long generations){
+    for (unsigned j = 0; j < 64 && (generations >> j) != 0; j++){
+        if (((generations >> j) & 1) == 0){continue;}
+        // Keeps the root (and the cell coordinates) within 64 bits.
+        unsigned long long jumps = (j > max_jump) ? 1ULL << (j - max_jump) : 1;
+        for (unsigned long long k = 0; k < jumps; k++){
+            advance(std :: min(j, max_jump));
+            if (m_nodes.size() > gc_threshold){collect();}
+        }
+    }
+};
+
+/**
+ * @brief Sets the birth and survival conditions.
+ *
+ * The memoized results were computed with the previous rule, so they are dropped.
+ * @param rule The new rule.
+ */
+void HashLife :: rule(const Rule& rule){
+    if (rule == m_rule){return;}
+    m_rule = rule;
+    m_results.clear();
+};
+
+/**
+ * @brief Rebuilds the node table with only the nodes reachable from the root.
+ */
+void HashLife :: collect(void){
+    std :: vector<Node> old;
+    old.swap(m_nodes);
+    m_index.clear();
+    m_results.clear();
+    m_empty.clear();
+    m_nodes.push_back(old[0]);
+    m_nodes.push_back(old[1]);
+    std :: unordered_map<node_t, node_t> moved;
+    m_root = copy_node(old, m_root, moved);
+};
+
+/**
+ * @brief Recreates a node (and its quadrants) in the current node table.
+ * @param nodes Node table the node comes from.
+ * @param n Node to copy.
+ * @param moved Nodes already copied, old index to new index.
+ * @return Index of the node in the current table.
+ */
+HashLife :: node_t HashLife :: copy_node(const std :: vector<Node>& nodes, node_t n, std :: unordered_map<node_t, node_t>& moved){
+    if (n < 2){return n;}
+    auto found = moved.find(n);
+    if (found != moved.end()){return found->second;}
+    const Node& a = nodes[n];
+    node_t copy = join(copy_node(nodes, a.nw, moved), copy_node(nodes, a.ne, moved),
+                       copy_node(nodes, a.sw, moved), copy_node(nodes, a.se, moved));
+    moved.emplace(n, copy);
+    return copy;
+};
+
+/**
+ * @brief Reads a cell of a node.
+ * @param n Node.
+ * @param x Column, relative to the west border of the node.
+ * @param y Row, relative to the north border of the node.
+ * @return True if the cell is alive.
+ */
+bool HashLife :: get_cell(node_t n, uint64_t x, uint64_t y) const{
+    while (m_nodes[n].level > 0){
+        const Node& a = m_nodes[n];
+        if (a.pop == 0){return false;}
+        uint64_t half = uint64_t(1) << (a.level - 1);
+        if (y < half){n = (x < half) ? a.nw : a.ne;}
+        else {n = (x < half) ? a.sw : a.se;}
+        x %= half;
+        y %= half;
+    }
+    return n == 1;
+};
+
+/**
+ * @brief Changes one cell of a node.
+ * @param n Node.
+ * @param x Column, relative to the west border of the node.
+ * @param y Row, relative to the north border of the node.
+ * @param alive New state of the cell.
+ * @return The node with the cell changed.
+ */
+HashLife :: node_t HashLife :: set_cell(node_t n, uint64_t x, uint64_t y, bool alive){
+    Node a = m_nodes[n];
+    if (a.level == 0){return alive ? 1 : 0;}
+    uint64_t half = uint64_t(1) << (a.level - 1);
+    if (y < half){
+        if (x < half){a.nw = set_cell(a.nw, x, y, alive);}
+        else {a.ne = set_cell(a.ne, x - half, y, alive);}
+    }
+    else {
+        if (x < half){a.sw = set_cell(a.sw, x, y - half, alive);}
+        else {a.se = set_cell(a.se, x - half, y - half, alive);}
+    }
+    return join(a.nw, a.ne, a.sw, a.se);
+};
+
+/**
+ * @brief Returns the state of a cell of the window.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @return True if the cell is alive.
+ */
+bool HashLife :: get(size_t row, size_t col) const{
+    uint64_t half = uint64_t(1) << (m_nodes[m_root].level - 1);
+    if (row >= half || col >= half){return false;}
+    return get_cell(m_root, col + half, row + half);
+};
+
+/**
+ * @brief Sets the state of a cell of the window.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @param alive New state of the cell.
+ */
+void HashLife :: set(size_t row, size_t col, bool alive){
+    while ((uint64_t(1) << (m_nodes[m_root].level - 1)) <= std :: max<uint64_t>(row, col)){
+        m_root = expand(m_root);
+    }
+    uint64_t half = uint64_t(1) << (m_nodes[m_root].level - 1);
+    m_root = set_cell(m_root, col + half, row + half, alive);
+};
+
+/**
+ * @brief Shrinks the root to the smallest centered node with every alive cell.
+ *
+ * The same pattern may sit in roots of different levels; the shrunk root is
+ * the same node for all of them.
+ * @return The shrunk root.
+ */
+HashLife :: node_t HashLife :: shrunk_root(void){
+    node_t n = m_root;
+    while (m_nodes[n].level > 1 && m_nodes[centre(n)].pop == m_nodes[n].pop){
+        n = centre(n);
+    }
+    return n;
+};
+
+/**
+ * @brief Returns the structural hash of the whole pattern.
+ * @return Hash of the shrunk root.
+ */
+uint64_t HashLife :: fingerprint(void){
+    return m_nodes[shrunk_root()].hash;
+};
+
+/**
+ * @brief Writes the quadtree of the whole pattern.
+ *
+ * Every distinct node of the shrunk root is written once, after its
+ * quadrants, as four codes: 0 or 1 for a cell, 2 + k for the k-th node
+ * written. Repetitive patterns therefore have small snapshots, and two
+ * patterns are equal exactly when their snapshots are.
+ * @param out Receives the codes.
+ */
+void HashLife :: snapshot(std :: vector<uint64_t>& out){
+    out.clear();
+    std :: unordered_map<node_t, uint64_t> seen;
+    serialize(shrunk_root(), out, seen);
+};
+
+/**
+ * @brief Writes a node after its quadrants, unless already written.
+ * @param n Node.
+ * @param out Snapshot being written.
+ * @param seen Code of each node already written.
+ * @return Code of the node.
+ */
+uint64_t HashLife :: serialize(node_t n, std :: vector<uint64_t>& out, std :: unordered_map<node_t, uint64_t>& seen) const{
+    if (m_nodes[n].level == 0){return n;}
+    auto found = seen.find(n);
+    if (found != seen.end()){return found->second;}
+    const Node a = m_nodes[n];
+    uint64_t codes[4] = {serialize(a.nw, out, seen), serialize(a.ne, out, seen),
+                         serialize(a.sw, out, seen), serialize(a.se, out, seen)};
+    out.insert(out.end(), codes, codes + 4);
+    uint64_t code = 2 + seen.size();
+    seen.emplace(n, code);
+    return code;
+};
+
+}  // namespace life
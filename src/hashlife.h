@@ -0,0 +1,130 @@
+//! This class implements the HashLife algorithm.
+/*!
+ * @file hashlife.h
+ *
+ * @details Class HashLife, a memoized quadtree engine over the infinite plane.
+ */
+
+#ifndef _HASHLIFE_H_
+#define _HASHLIFE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "engine.h"
+
+namespace life {
+
+/// Gosper's HashLife over the unbounded plane.
+/*!
+ * The plane is a quadtree whose nodes are canonicalized: two regions with the
+ * same contents are the same node, found through a hash table. The result of
+ * advancing the center of a node by 2^j generations is memoized per node, so
+ * repetitive patterns (guns, breeders, oscillators) are computed once and the
+ * engine can jump 2^j generations in a single call, for j as large as needed.
+ *
+ * There is no torus here: patterns grow freely and nothing wraps around.
+ */
+class HashLife : public Engine {
+    public:
+    typedef uint32_t node_t;                        //!< Node index.
+    static constexpr size_t gc_threshold = 1 << 22; //!< # of nodes that triggers a collection.
+    static constexpr unsigned max_jump = 60;        //!< Largest j of a single 2^j jump.
+
+    private:
+    /// A square of 2^level x 2^level cells. Level 0 nodes are single cells.
+    struct Node {
+        node_t nw, ne, sw, se;          //!< Quadrants (unused at level 0).
+        unsigned long long pop;         //!< # of alive cells.
+        uint64_t hash;                  //!< Structural hash of the contents.
+        unsigned level;                 //!< log2 of the side.
+    };
+
+    /// Hash table key: the four quadrants.
+    struct Key {
+        node_t nw, ne, sw, se;
+        bool operator==(const Key& rhs) const {
+            return nw == rhs.nw && ne == rhs.ne && sw == rhs.sw && se == rhs.se;
+        }
+    };
+
+    /// Hash of a key.
+    struct KeyHash {
+        size_t operator()(const Key& k) const;
+    };
+
+    size_t m_rows;                                      //!< # of rows of the window.
+    size_t m_cols;                                      //!< # of columns of the window.
+    std::vector<Node> m_nodes;                          //!< Every node; 0 and 1 are the dead and alive cells.
+    std::unordered_map<Key, node_t, KeyHash> m_index;   //!< Canonical node of each quadrant tuple.
+    std::unordered_map<uint64_t, node_t> m_results;     //!< Memo of successor(node, j).
+    std::vector<node_t> m_empty;                        //!< Empty node of each level.
+    node_t m_root;                                      //!< Centered on the origin.
+    Rule m_rule;                                        //!< Birth and survival conditions.
+
+    //!< Returns the canonical node with the given quadrants.
+    node_t join(node_t nw, node_t ne, node_t sw, node_t se);
+
+    //!< Returns the empty node of a level.
+    node_t empty(unsigned level);
+
+    //!< Returns a node one level up, with the same center and contents.
+    node_t expand(node_t n);
+
+    //!< Returns the center half of a node.
+    node_t centre(node_t n);
+
+    //!< Returns the center half of two side by side nodes.
+    node_t centre_h(node_t w, node_t e);
+
+    //!< Returns the center half of two stacked nodes.
+    node_t centre_v(node_t n, node_t s);
+
+    //!< Returns the center of a level 2 node after one generation.
+    node_t base_step(node_t n);
+
+    //!< Returns the center half of a node after 2^j generations.
+    node_t successor(node_t n, unsigned j);
+
+    //!< Returns true if all cells of the root lie inside its central quarter.
+    bool centred(node_t n) const;
+
+    //!< Reads a cell, in coordinates relative to the node corner.
+    bool get_cell(node_t n, uint64_t x, uint64_t y) const;
+
+    //!< Returns a copy of a node with one cell changed.
+    node_t set_cell(node_t n, uint64_t x, uint64_t y, bool alive);
+
+    //!< Advances the root by 2^j generations.
+    void advance(unsigned j);
+
+    //!< Returns the smallest centered node holding every alive cell.
+    node_t shrunk_root(void);
+
+    //!< Appends the quadrants of a node, and of its descendants, to a snapshot.
+    uint64_t serialize(node_t n, std::vector<uint64_t>& out, std::unordered_map<node_t, uint64_t>& seen) const;
+
+    //!< Drops the nodes not reachable from the root.
+    void collect(void);
+
+    //!< Copies a node into a fresh node table.
+    node_t copy_node(const std::vector<Node>& nodes, node_t n, std::unordered_map<node_t, node_t>& moved);
+
+    public:
+    HashLife(size_t rows, size_t cols);
+
+    size_t rows(void) const override { return m_rows; }
+    size_t cols(void) const override { return m_cols; }
+    bool get(size_t row, size_t col) const override;
+    void set(size_t row, size_t col, bool alive) override;
+    unsigned long long population(void) const override { return m_nodes[m_root].pop; }
+    void step(unsigned long long generations) override;
+    void rule(const Rule& rule) override;
+    uint64_t fingerprint(void) override;
+    void snapshot(std::vector<uint64_t>& out) override;
+};
+
+}  // namespace life
+
+#endif
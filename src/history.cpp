@@ -0,0 +1,129 @@
+/**
+ * History class implementation.
+ *
+ */
+
+#include "history.h"
+#include "lodepng.h"
+#include <cstring>
+
+namespace life {
+
+/**
+ * @brief Returns the deflate settings of the past boards.
+ *
+ * A board is compressed every generation, on the thread that steps it, so
+ * speed wins over ratio: a short window and match search, and no lazy
+ * matching, which compress mostly empty boards nearly as well.
+ * @return The settings.
+ */
+static const LodePNGCompressSettings& fast_deflate(void){
+    static const LodePNGCompressSettings settings = [](){
+        LodePNGCompressSettings s;
+        lodepng_compress_settings_init(&s);
+        s.windowsize = 256;
+        s.nicematch = 32;
+        s.lazymatching = 0;
+        return s;
+    }();
+    return settings;
+};
+
+/**
+ * @brief Constructor for History class.
+ * @param max_bytes Memory limit for the boards, in bytes (0: none).
+ */
+History :: History(size_t max_bytes) :
+    m_index(),
+    m_entries(),
+    m_first(0),
+    m_bytes(0),
+    m_max_bytes(max_bytes),
+    m_evicted(0)
+    {}
+
+/**
+ * @brief Forgets every recorded board. The memory limit is kept.
+ */
+void History :: clear(void){
+    m_index.clear();
+    m_entries.clear();
+    m_first = 0;
+    m_bytes = 0;
+    m_evicted = 0;
+};
+
+/**
+ * @brief Looks for a board among the recorded ones.
+ * @param fingerprint Fingerprint of the board.
+ * @param snapshot The board, compared only against fingerprint matches.
+ * @param gen Generation at which the board was recorded, if found.
+ * @return True if the board was recorded before.
+ */
+bool History :: find(uint64_t fingerprint, const snapshot_t& snapshot, unsigned long long& gen) const{
+    return find_if(fingerprint, [&snapshot](const snapshot_t& past){ return past == snapshot; }, gen);
+};
+
+/**
+ * @brief Looks for a recorded board that satisfies a predicate.
+ *
+ * Only the boards recorded with the given fingerprint are decompressed.
+ * @param fingerprint Fingerprint of the board.
+ * @param match Returns true if a past board is the one looked for.
+ * @param gen Generation of the first board accepted by match, if any.
+ * @return True if a recorded board was accepted.
+ */
+bool History :: find_if(uint64_t fingerprint, const std :: function<bool(const snapshot_t&)>& match, unsigned long long& gen) const{
+    std :: vector<unsigned char> data;
+    snapshot_t past;
+    auto range = m_index.equal_range(fingerprint);
+    for (auto it = range.first; it != range.second; ++it){
+        const Entry& entry = m_entries[it->second - m_first];
+        data.clear();
+        if (lodepng :: decompress(data, entry.data) != 0){continue;}
+        past.resize(data.size() / sizeof(uint64_t));
+        if (!data.empty()){std :: memcpy(past.data(), data.data(), past.size() * sizeof(uint64_t));}
+        if (match(past)){
+            gen = entry.gen;
+            return true;
+        }
+    }
+    return false;
+};
+
+/**
+ * @brief Records a board.
+ * @param fingerprint Fingerprint of the board.
+ * @param gen Generation of the board.
+ * @param snapshot The board.
+ */
+void History :: insert(uint64_t fingerprint, unsigned long long gen, const snapshot_t& snapshot){
+    Entry entry{fingerprint, gen, {}};
+    lodepng :: compress(entry.data, reinterpret_cast<const unsigned char*>(snapshot.data()), snapshot.size() * sizeof(uint64_t), fast_deflate());
+    entry.data.shrink_to_fit();
+    m_bytes += entry.data.capacity() + sizeof(Entry);
+    m_index.emplace(fingerprint, m_first + m_entries.size());
+    m_entries.push_back(std :: move(entry));
+    // The newest board is always kept, even if it alone is over the limit.
+    while (m_max_bytes != 0 && m_bytes > m_max_bytes && m_entries.size() > 1){evict();}
+};
+
+/**
+ * @brief Drops the oldest board.
+ */
+void History :: evict(void){
+    const Entry& entry = m_entries.front();
+    auto range = m_index.equal_range(entry.fingerprint);
+    for (auto it = range.first; it != range.second; ++it){
+        if (it->second == m_first){
+            m_index.erase(it);
+            break;
+        }
+    }
+    m_bytes -= entry.data.capacity() + sizeof(Entry);
+    m_entries.pop_front();
+    m_first++;
+    m_evicted++;
+};
+
+}  // namespace life
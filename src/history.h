@@ -0,0 +1,90 @@
+//! This class implements the set of boards already generated.
+/*!
+ * @file history.h
+ *
+ * @details Class History, used to detect that a simulation became stable.
+ */
+
+#ifndef _HISTORY_H_
+#define _HISTORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace life {
+
+/// Past boards, indexed by fingerprint and kept deflate-compressed.
+/*!
+ * Looking a board up costs one hash probe. Boards are only decompressed and
+ * compared when their 64-bit fingerprints collide, which in practice means
+ * only when the board really repeats.
+ *
+ * Boards are stored bit-packed and zlib-compressed (with the deflate code of
+ * lodepng), which shrinks the mostly empty or settled boards of long runs
+ * by a large factor. When a memory limit is set, the oldest boards are
+ * dropped to stay under it, like a ring buffer: a cycle that started before
+ * them can then no longer be detected.
+ */
+class History {
+    public:
+    typedef std::vector<uint64_t> snapshot_t;   //!< Compact copy of a board.
+
+    private:
+    /// A past board.
+    struct Entry {
+        uint64_t fingerprint;               //!< Fingerprint of the board.
+        unsigned long long gen;             //!< Generation of the board.
+        std::vector<unsigned char> data;    //!< The board, compressed.
+    };
+
+    std::unordered_multimap<uint64_t, size_t> m_index;  //!< Fingerprint to entry # (counted from the first entry ever).
+    std::deque<Entry> m_entries;                        //!< Boards still kept, oldest first.
+    size_t m_first;                                     //!< Entry # of m_entries.front().
+    size_t m_bytes;                                     //!< Memory used by the boards kept.
+    size_t m_max_bytes;                                 //!< Memory limit (0: none).
+    unsigned long long m_evicted;                       //!< # of boards dropped to honor the limit.
+
+    //!< Drops the oldest board.
+    void evict(void);
+
+    public:
+    History(size_t max_bytes = 0);
+
+    //!< Sets the memory limit, in bytes (0: none).
+    void limit(size_t max_bytes) { m_max_bytes = max_bytes; }
+
+    //!< Returns the memory limit, in bytes (0: none).
+    size_t limit(void) const { return m_max_bytes; }
+
+    //!< Forgets every board.
+    void clear(void);
+
+    //!< Looks a board up; on success, gen receives the generation it was first seen.
+    bool find(uint64_t fingerprint, const snapshot_t& snapshot, unsigned long long& gen) const;
+
+    //!< Looks for a board with the given fingerprint accepted by match; on success, gen receives its generation.
+    bool find_if(uint64_t fingerprint, const std::function<bool(const snapshot_t&)>& match, unsigned long long& gen) const;
+
+    //!< Records a board, dropping the oldest ones if over the memory limit.
+    void insert(uint64_t fingerprint, unsigned long long gen, const snapshot_t& snapshot);
+
+    //!< Returns the # of boards kept.
+    size_t size(void) const { return m_entries.size(); }
+
+    //!< Returns the memory used by the boards kept, in bytes.
+    size_t bytes(void) const { return m_bytes; }
+
+    //!< Returns the # of boards dropped to honor the memory limit.
+    unsigned long long evicted(void) const { return m_evicted; }
+
+    //!< Returns the generation of the oldest board kept.
+    unsigned long long oldest(void) const { return m_entries.empty() ? 0 : m_entries.front().gen; }
+};
+
+}  // namespace life
+
+#endif
@@ -5,10 +5,21 @@
 
 #include "life.h"
 #include "common.h"
+#include "active_cells.h"
+#include "hashlife.h"
+#include "chunked_plane.h"
+#include "sharded_board.h"
+#include "sliced_boards.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <vector>
+#include <algorithm>
+#include <numeric>
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <limits>
 
 namespace life {
 /**
@@ -21,18 +32,50 @@ LifeCfg::LifeCfg() :
     m_extinct(false),
     m_exit(false),
     m_n_gen(1),
+    m_last_gen(0),
     m_cols(0),
     m_rows(0),
     m_maxgen(10),
+    m_gen_step(1),
+    m_temporal(1),
     m_fps(2),
+    m_threads(1),
+    m_schedule("bands"),
+    m_engine_name("bitboard"),
+    m_boundary("torus"),
+    m_kernel("adder"),
+    m_simd("auto"),
+    m_pin(false),
+    m_huge_pages(false),
+    m_shards(1),
+    m_rule(),
     m_back_color("green"),
     m_cell_color("red"),
     m_txt_file(""),
     m_image_dir(""),
     m_file_path(""),
+    m_words(0),
+    m_quiet(false),
     m_table(),
-    m_old_tables(),
-    m_canvas(0, 0, 5)
+    m_cycle_detect("history"),
+    m_history(),
+    m_history_warned(false),
+    m_history_store("auto"),
+    m_tile_history(),
+    m_brent(),
+    m_translations(),
+    m_cycle_start(0),
+    m_period(0),
+    m_shift_rows(0),
+    m_shift_cols(0),
+    m_on_cycle("stop"),
+    m_jumped(false),
+    m_frames(),
+    m_frames_gen(0),
+    m_canvas(),
+    m_painted(false),
+    m_painted_epoch(0),
+    m_pool()
     {}
 
 // TODO
@@ -41,7 +84,7 @@ LifeCfg::LifeCfg() :
  * @brief Updates the state of the simulation based on the current state (`m_state`).
  * 
  * The update function performs different actions based on the current state of the simulation:
- * - If `m_state` is `STARTING`, it reads the configuration file, initializes the canvas (`m_canvas`),
+ * - If `m_state` is `STARTING`, it reads the configuration file, drops any previous canvas (`m_canvas`),
  *   displays a welcome message, and transitions to the `RUNNING` state.
  * - If `m_state` is `RUNNING`, it checks if the simulation should stop (`m_stop`). If so, it transitions
  *   to the `END` state; otherwise, it displays the current state of the simulation (Conway's Game of Life),
@@ -54,9 +97,53 @@ LifeCfg::LifeCfg() :
 void LifeCfg :: update(void){
     switch(m_state){
         case state_e :: STARTING:
-            read_file();
-            m_canvas.start_canva(static_cast<short>(m_pixel), static_cast<size_t>(m_cols), static_cast<size_t>(m_rows));
-            display_welcome();
+            // Sharded tables are stepped by the threads of each worker process.
+            if (m_threads > 1 && m_shards == 1){m_pool.reset(new ThreadPool(m_threads, m_pin));}
+            m_table = read_file();
+            if (m_temporal > 1 && (m_engine_name != "bitboard" || m_kernel != "adder" || m_boundary == "cross")){
+                std :: cerr << "Temporal blocking needs the bitboard engine, the adder kernel and a boundary other than cross!" << std :: endl;
+                std :: exit(EXIT_FAILURE);
+            }
+            if (m_shards > 1 && (m_engine_name != "bitboard" || m_kernel != "adder" || m_temporal > 1 || m_boundary == "cross")){
+                std :: cerr << "Sharding needs the bitboard engine, the adder kernel, no temporal blocking and a boundary other than cross!" << std :: endl;
+                std :: exit(EXIT_FAILURE);
+            }
+            if (m_boundary != "torus" && (m_engine_name == "hashlife" || m_engine_name == "chunked")){
+                std :: cerr << "The " << m_engine_name << " engine runs on the unbounded plane, it has no boundary to choose!" << std :: endl;
+                std :: exit(EXIT_FAILURE);
+            }
+            if (m_engine_name == "sliced" && (m_gen_step != 1 || m_on_cycle != "stop" || m_cycle_detect != "history")){
+                std :: cerr << "The sliced engine advances one generation at a time and stops at the first cycle!" << std :: endl;
+                std :: exit(EXIT_FAILURE);
+            }
+            if ((m_rule.birth & 1) != 0 && m_engine_name != "bitboard" && m_engine_name != "sliced"){
+                std :: cerr << "Rules with B0 need the bitboard engine!" << std :: endl;
+                std :: exit(EXIT_FAILURE);
+            }
+            if (m_cycle_detect == "translation"){
+                if (m_engine_name == "hashlife" || m_engine_name == "chunked" || m_boundary != "torus"){
+                    std :: cerr << "Translation cycle detection needs a toroidal engine!" << std :: endl;
+                    std :: exit(EXIT_FAILURE);
+                }
+                m_translations.resize(m_rows, m_cols);
+            }
+            // Deflating the whole table every generation costs far more than stepping it,
+            // while the engines that stamp their tiles let the tile history read only the changed ones.
+            if (m_history_store == "auto"){
+                const bool stamped = m_engine_name == "bitboard" || m_engine_name == "active";
+                m_history_store = (stamped && m_cycle_detect == "history") ? "tiles" : "compressed";
+            }
+            if (m_history_store == "tiles"){
+                if (m_engine_name == "hashlife" || m_engine_name == "chunked" || m_cycle_detect != "history"){
+                    std :: cerr << "Tile history needs a toroidal engine and the \"history\" cycle detection!" << std :: endl;
+                    std :: exit(EXIT_FAILURE);
+                }
+                m_tile_history.resize(m_rows, m_cols);
+            }
+            // The canvas is only made when a frame is saved (see paint_pixel()).
+            m_canvas.reset();
+            m_painted = false;
+            if (!m_quiet){display_welcome();}
             m_state = state_e :: RUNNING;
             break;
         case state_e :: RUNNING:
@@ -64,24 +151,22 @@ void LifeCfg :: update(void){
                 m_state = state_e :: END;
                 break;
             }
-            display_conway();
+            m_last_gen = m_n_gen;
+            if (!m_quiet){display_conway();}
             if (m_image_dir != ""){
-                size_t height = m_canvas.height();
-                size_t width = m_canvas.width();
-                unsigned block_size = m_pixel;
-                Canvas canvas(width, height, block_size);
-                paint_pixel(m_table, canvas);
+                paint_pixel(*m_table);
+                size_t height = m_canvas->height();
+                size_t width = m_canvas->width();
                 make_words(m_image_dir);
                 string ppm = m_file_path + ".ppm";
                 string png = m_file_path + ".png";
-                canvas.encode_png(png, canvas.pixels(), width, height);
-                canvas.save(canvas.pixels(), width, height, 4, ppm);
-                
+                m_canvas->encode_png(png, m_canvas->pixels(), width, height);
+                m_canvas->save(m_canvas->pixels(), width, height, 4, ppm);
             }
             update_gen();
             break;
         case state_e :: END:
-            display_end();
+            if (!m_quiet){display_end();}
             m_exit = true;
             break;
         case state_e :: UNDEFINED:
@@ -89,6 +174,101 @@ void LifeCfg :: update(void){
     }
 };
 
+/**
+ * @brief Runs several configurations to their end at once, with the sliced engine.
+ *
+ * The configurations must share their size and options, and differ only
+ * in their input file; each one becomes a board of a SlicedBoards, so one
+ * pass of the kernel advances all of them. Every board is looked up among
+ * its own past boards by fingerprint, and ends exactly as update() would
+ * end it, in the same generation. Since fingerprints may collide, the
+ * boards then run again from the start, and every repetition is confirmed
+ * by an exact comparison with the board it repeats; a configuration whose
+ * repetition was a collision (which should never be seen in practice) is
+ * simulated again on its own.
+ * @param pack 1 to 64 configurations, set up alike but for their input file.
+ */
+void LifeCfg :: run_sliced(const std :: vector<LifeCfg*>& pack){
+    const size_t n_lanes = pack.size();
+    std :: vector<std :: unique_ptr<Engine>> seeds;
+    for (LifeCfg* cw : pack){seeds.push_back(cw->read_file());}
+    const LifeCfg& first = *pack.front();
+    auto load = [&](SlicedBoards& boards){
+        boards.rule(first.m_rule);
+        for (size_t lane = 0; lane < n_lanes; lane++){
+            for (size_t i = 0; i < first.m_rows; i++){
+                for (size_t j = 0; j < first.m_cols; j++){
+                    if (seeds[lane]->get(i, j)){boards.set(lane, i, j, true);}
+                }
+            }
+        }
+    };
+    SlicedBoards boards(first.m_rows, first.m_cols, first.boundary_mode());
+    load(boards);
+    std :: vector<std :: unordered_map<uint64_t, unsigned long long>> seen(n_lanes);
+    std :: array<uint64_t, SlicedBoards :: lanes> fingerprints;
+    const uint64_t all = (n_lanes == SlicedBoards :: lanes) ? ~uint64_t(0) : (uint64_t(1) << n_lanes) - 1;
+    uint64_t pending = all;
+    uint64_t repeated = 0;
+    unsigned long long last = 0;
+    for (unsigned long long gen = 1; pending != 0; gen++){
+        if (gen > 1){boards.step(1);}
+        boards.fingerprints(fingerprints);
+        const uint64_t alive = boards.alive();
+        for (uint64_t lanes = pending; lanes != 0; lanes &= lanes - 1){
+            const size_t lane = static_cast<size_t>(__builtin_ctzll(lanes));
+            LifeCfg& cw = *pack[lane];
+            auto past = seen[lane].emplace(fingerprints[lane], gen);
+            const bool repeats = !past.second;
+            // Same order as update_gen(): a later condition overrides an earlier one.
+            if (repeats){cw.m_ending = ending_e :: STABILITY;}
+            if (cw.m_maxgen == gen + 1){cw.m_ending = ending_e :: MAXGEN;}
+            if (((alive >> lane) & 1) == 0){cw.m_ending = ending_e :: EXTINCTION;}
+            if (cw.m_ending == ending_e :: UNDEFINED){continue;}
+            if (repeats){
+                cw.m_cycle_start = past.first->second;
+                cw.m_period = gen - cw.m_cycle_start;
+                repeated |= uint64_t(1) << lane;
+            }
+            cw.m_last_gen = gen;
+            last = gen;
+            pending &= ~(uint64_t(1) << lane);
+            std :: unordered_map<uint64_t, unsigned long long>().swap(seen[lane]);
+        }
+    }
+    // Confirms every repetition: board m_cycle_start is kept aside until board m_last_gen.
+    uint64_t collided = 0;
+    if (repeated != 0){
+        SlicedBoards replay(first.m_rows, first.m_cols, first.boundary_mode());
+        SlicedBoards kept(first.m_rows, first.m_cols, first.boundary_mode());
+        load(replay);
+        for (unsigned long long gen = 1; gen <= last; gen++){
+            if (gen > 1){replay.step(1);}
+            uint64_t due = 0;
+            for (uint64_t lanes = repeated; lanes != 0; lanes &= lanes - 1){
+                const size_t lane = static_cast<size_t>(__builtin_ctzll(lanes));
+                if (pack[lane]->m_cycle_start == gen){kept.copy_lane(replay, lane);}
+                if (pack[lane]->m_last_gen == gen){due |= uint64_t(1) << lane;}
+            }
+            if (due != 0){collided |= due & ~replay.equal(kept);}
+        }
+    }
+    for (size_t lane = 0; lane < n_lanes; lane++){
+        LifeCfg& cw = *pack[lane];
+        if ((collided >> lane) & 1){
+            cw.m_ending = ending_e :: UNDEFINED;
+            cw.m_cycle_start = 0;
+            cw.m_period = 0;
+            cw.m_engine_name = "bitboard";
+            cw.m_state = state_e :: STARTING;
+            while (not cw.exit_conway()){cw.update();}
+            continue;
+        }
+        cw.m_stop = true;
+        cw.m_exit = true;
+    }
+};
+
 /**
  * @brief Returns the number of rows in the simulation grid.
  * @return Number of rows.
@@ -105,7 +285,7 @@ unsigned int LifeCfg :: cols(void) const{return m_cols;};
  * @brief Returns the maximum number of generations for the simulation.
  * @return Maximum number of generations.
  */
-unsigned int LifeCfg :: max_gen(void) const{return m_maxgen;};
+unsigned long long LifeCfg :: max_gen(void) const{return m_maxgen;};
 
 /**
  * @brief Returns the frames per second (fps) setting for the simulation.
@@ -113,6 +293,12 @@ unsigned int LifeCfg :: max_gen(void) const{return m_maxgen;};
  */
 unsigned int LifeCfg :: fps(void) const{return m_fps;};
 
+/**
+ * @brief Returns the number of threads used to step the simulation grid.
+ * @return Number of threads.
+ */
+unsigned int LifeCfg :: threads(void) const{return m_threads;};
+
 /**
  * @brief Returns the background color setting for the simulation.
  * @return Background color.
@@ -141,106 +327,272 @@ std :: string& LifeCfg :: image_dir(void){return m_image_dir;};
  * @brief Returns the current state of the simulation grid.
  * @return Current simulation grid.
  */
-std :: vector<std :: vector<unsigned int>> LifeCfg :: table(void) const{return m_table;};
+const Engine& LifeCfg :: table(void) const{return *m_table;};
 
 /**
- * @brief Returns a list of all previous simulation states.
- * @return List of previous simulation states.
+ * @brief Checks if the simulation has reached its end condition.
+ * @return True if the simulation has reached its end, false otherwise.
  */
-std :: vector<std :: string> LifeCfg :: old_tables(void) const{return m_old_tables;}; 
+bool LifeCfg :: exit_conway() const{
+    if (m_exit){return true;}
+    else{return false;}
+};
 
 /**
- * @brief Compares the current simulation state with previously saved states.
- * @param olds List of previous simulation states.
- * @param table Current simulation state as a string.
- * @return True if the current state matches any previous state, false otherwise.
+ * @brief Returns why the simulation ended.
+ * @return "extinction", "maxgen", "stability", or "undefined" while it runs.
  */
-bool LifeCfg :: compare(vector<string> olds, string table){
-    for (long unsigned int i = 0; i < olds.size(); i++){
-        if (olds[i] == table){return true;}
+std :: string LifeCfg :: ending(void) const{
+    switch(m_ending){
+        case ending_e :: EXTINCTION: return "extinction";
+        case ending_e :: MAXGEN: return "maxgen";
+        case ending_e :: STABILITY: return "stability";
+        case ending_e :: UNDEFINED: break;
     }
-    return false; 
+    return "undefined";
 };
 
 /**
- * @brief Checks if all cells in the simulation grid are dead.
- * @param table Current simulation state as a string.
- * @return True if all cells are dead, false otherwise.
+ * @brief Returns the last generation shown (or painted), even when quiet.
+ * @return Generation #, 0 before the first one.
  */
-bool LifeCfg :: all_dead(std :: string table){
-    for (char c : table){
-        if (c == '1'){return false;}
-    }
-    return true;
-};
+unsigned long long LifeCfg :: generation(void) const{return m_last_gen;};
 
 /**
- * @brief Checks if the simulation has reached its end condition.
- * @return True if the simulation has reached its end, false otherwise.
+ * @brief Returns the period of the cycle the simulation fell into.
+ * @return # of generations of the cycle, 0 if no cycle was found.
  */
-bool LifeCfg :: exit_conway() const{
-    if (m_exit){return true;}
-    else{return false;}
+unsigned long long LifeCfg :: period(void) const{return m_period;};
+
+/**
+ * @brief Reads the header of a configuration: the line with the # of rows and
+ * columns, and the line with the character of the alive cells.
+ * @param file Stream at the start of the configuration.
+ * @param rows Receives the # of rows.
+ * @param cols Receives the # of columns.
+ * @param alive Receives the character of the alive cells.
+ * @throw std::runtime_error if the header is missing or invalid.
+ */
+void LifeCfg :: read_header(std :: istream& file, size_t& rows, size_t& cols, char& alive){
+    std :: string line;
+    std :: getline(file, line);
+    std :: istringstream iss(line);
+    size_t* dims[2] = {&rows, &cols};
+    for (size_t* dim : dims){
+        std :: string token;
+        if (!(iss >> token) || token.find_first_not_of("0123456789") != std :: string :: npos){
+            throw std :: runtime_error("Error reading dimensions from file!");
+        }
+        unsigned long long value;
+        try {value = std :: stoull(token);}
+        catch (const std :: out_of_range&){value = ~0ULL;}
+        if (value > std :: numeric_limits<unsigned int> :: max()){
+            throw std :: runtime_error("The dimensions stated are too large.");
+        }
+        *dim = static_cast<size_t>(value);
+    }
+    if (rows < 3 || cols < 3){throw std :: runtime_error("The dimensions stated are insufficient.");}
+    if (!std :: getline(file, line) || line.empty()){
+        throw std :: runtime_error("Error reading the alive cell character from file!");
+    }
+    alive = line[0];
 };
 
 /**
  * @brief Reads the initial configuration from a file.
+ * @return A new engine holding the initial configuration.
+ * @throw std::runtime_error if the file cannot be opened or its header is invalid.
  */
-void LifeCfg :: read_file(void){
+std :: unique_ptr<Engine> LifeCfg :: read_file(void){
     std :: ifstream file(m_txt_file);
-    if (!file.is_open()){
-        std :: cerr << "Unable to open the file!" << std :: endl;
-        std :: exit(EXIT_FAILURE);
+    if (!file.is_open()){throw std :: runtime_error("Unable to open the file!");}
+    size_t rows, cols;
+    char alive;
+    read_header(file, rows, cols, alive);
+    m_rows = static_cast<unsigned>(rows);
+    m_cols = static_cast<unsigned>(cols);
+    std :: unique_ptr<Engine> table;
+    const boundary_e boundary = boundary_mode();
+    if (m_engine_name == "hashlife"){
+        table.reset(new HashLife(m_rows, m_cols));
+    }
+    else if (m_engine_name == "chunked"){
+        ChunkedPlane* plane = new ChunkedPlane(m_rows, m_cols);
+        plane->pool(m_pool.get());
+        table.reset(plane);
+    }
+    else if (m_engine_name == "active"){
+        table.reset(new ActiveCells(m_rows, m_cols, boundary));
     }
+    else if (m_shards > 1){
+        if (m_shards > m_rows){
+            throw std :: runtime_error("The table has fewer rows than the " + std :: to_string(m_shards) + " shards asked for!");
+        }
+        table.reset(new ShardedBoard(m_rows, m_cols, m_shards, boundary, m_threads));
+    }
+    else {
+        // The workers zero the bands they step as the board is sized (first touch).
+        BitBoard* board = new BitBoard();
+        board->pool(m_pool.get());
+        board->huge_pages(m_huge_pages);
+        board->resize(m_rows, m_cols);
+        board->boundary(boundary);
+        board->depth(m_temporal);
+        board->schedule(m_schedule == "tiles" ? BitBoard :: schedule_e :: TILES :
+                        m_schedule == "wavefront" ? BitBoard :: schedule_e :: WAVEFRONT : BitBoard :: schedule_e :: BANDS);
+        board->kernel(m_kernel == "lut16" ? BitBoard :: kernel_e :: LUT16 :
+                      m_kernel == "lut" ? BitBoard :: kernel_e :: LUT : BitBoard :: kernel_e :: ADDER);
+        if (m_simd != "auto"){
+            board->simd(m_simd == "avx512" ? simd_e :: AVX512 : m_simd == "avx2" ? simd_e :: AVX2 :
+                        m_simd == "sse2" ? simd_e :: SSE2 : simd_e :: SCALAR);
+        }
+        table.reset(board);
+    }
+    table->rule(m_rule);
     std :: string line;
-    std :: getline(file, line);
-    std::istringstream iss(line);
-    std::string token;
-    if (!(iss >> token)) {
-        std::cerr << "Error reading dimensions from file!" << std::endl;
-        std::exit(EXIT_FAILURE);
-    }
-    m_rows = std::stoi(token);
-    if (!(iss >> token)) {
-        std::cerr << "Error reading dimensions from file!" << std::endl;
-        std::exit(EXIT_FAILURE);
-    }
-    m_cols = std::stoi(token);   
-    if (m_cols < 3 || m_rows < 3) {
-        std::cerr << "The dimensions stated are insufficient." << std::endl;
-        std::exit(EXIT_FAILURE);
-    }   
-    m_table.resize(m_rows, std::vector<unsigned int>(m_cols, 0));
-    std :: getline(file, line);
-    char alive = line[0];
     unsigned int i = 0;
     while(std :: getline(file, line)){
-        for (unsigned int j = 0; j < m_cols; j++){
-            if (line[j] == alive){
-                m_table[i][j] = 1;
-            }
-            else {m_table[i][j] = 0;}
+        for (unsigned int j = 0; j < m_cols && j < line.size(); j++){
+            if (line[j] == alive){table->set(i, j, true);}
         }
         i++;
         if (i >= m_rows){break;}
     }
     file.close();
+    return table;
+};
+
+/**
+ * @brief Returns the topology named by the boundary option.
+ * @return Topology of the bounded engines.
+ */
+boundary_e LifeCfg :: boundary_mode(void) const{
+    return m_boundary == "dead" ? boundary_e :: DEAD :
+           m_boundary == "klein" ? boundary_e :: KLEIN :
+           m_boundary == "cross" ? boundary_e :: CROSS : boundary_e :: TORUS;
+};
+
+/**
+ * @brief Finds where a cycle starts by replaying the simulation.
+ *
+ * Two copies of the initial configuration are read, one of them is moved
+ * a period ahead, and both advance together until they meet. Only two
+ * boards are alive at any time.
+ * @param period # of generations of the cycle.
+ * @return Generation at which the cycle starts.
+ */
+unsigned long long LifeCfg :: cycle_start(unsigned long long period){
+    std :: unique_ptr<Engine> tortoise = read_file();
+    std :: unique_ptr<Engine> hare = read_file();
+    hare->step(period);
+    unsigned long long start = 1;
+    History :: snapshot_t a, b;
+    while (true){
+        if (tortoise->fingerprint() == hare->fingerprint()){
+            tortoise->snapshot(a);
+            hare->snapshot(b);
+            if (a == b){return start;}
+        }
+        tortoise->step(m_gen_step);
+        hare->step(m_gen_step);
+        start += m_gen_step;
+    }
+};
+
+/**
+ * @brief Tells whether a table comes back after some # of generations, by replaying the simulation.
+ *
+ * With the "translation" cycle detection the table may come back shifted
+ * around the torus, which is then told by dy and dx.
+ * @param gen Generation of the first table.
+ * @param distance # of generations between the two tables.
+ * @param dy Receives the # of rows the table moved down (negative: up).
+ * @param dx Receives the # of columns the table moved right (negative: left).
+ * @return True if table gen and table gen + distance are the same.
+ */
+bool LifeCfg :: repeats(unsigned long long gen, unsigned long long distance, long long& dy, long long& dx){
+    std :: unique_ptr<Engine> tortoise = read_file();
+    std :: unique_ptr<Engine> hare = read_file();
+    tortoise->step(gen - 1);
+    hare->step(gen - 1 + distance);
+    dy = 0;
+    dx = 0;
+    History :: snapshot_t a, b;
+    if (m_cycle_detect == "translation"){
+        TranslationHistory past(m_rows, m_cols);
+        unsigned long long seen = gen;
+        tortoise->snapshot(a);
+        hare->snapshot(b);
+        past.insert(seen, a, dy, dx);
+        return past.insert(seen, b, dy, dx);
+    }
+    if (tortoise->fingerprint() != hare->fingerprint()){return false;}
+    tortoise->snapshot(a);
+    hare->snapshot(b);
+    return a == b;
 };
 
 /**
- * @brief Converts the simulation grid to a string representation.
- * @param table Simulation grid to convert.
- * @return String representation of the simulation grid.
+ * @brief Finds the exact period of a cycle.
+ *
+ * With a step above 1 only every m_gen_step-th table is looked at, so the
+ * distance between two equal tables is a multiple of m_gen_step, and of the
+ * period: the least common multiple of both, at best. The tables of a
+ * cycle come back after d generations exactly when d is a multiple of the
+ * period, so each prime factor is divided out while the table still comes
+ * back: one replay per prime factor of the distance, none with a step of 1.
+ * A translating cycle moves a fraction of the distance's shift each
+ * period, so m_shift_rows and m_shift_cols follow the period down.
+ * @param sampled Generation of a table of the cycle.
+ * @param distance # of generations after which that table came back.
+ * @return # of generations of the cycle.
  */
-std :: string LifeCfg :: table_to_string(std :: vector<std :: vector<unsigned int>>& table){
-    std :: stringstream ss;
-    for (const auto& row : table) {
-        for (const auto& cell : row){
-            ss << cell;
+unsigned long long LifeCfg :: exact_period(unsigned long long sampled, unsigned long long distance){
+    if (m_gen_step == 1){return distance;}
+    std :: vector<unsigned long long> primes;
+    unsigned long long rest = distance;
+    for (unsigned long long q = 2; q <= rest / q; q++){
+        if (rest % q != 0){continue;}
+        primes.push_back(q);
+        while (rest % q == 0){rest /= q;}
+    }
+    if (rest > 1){primes.push_back(rest);}
+    unsigned long long period = distance;
+    long long dy, dx;
+    for (unsigned long long q : primes){
+        while (period % q == 0 && repeats(sampled, period / q, dy, dx)){
+            period /= q;
+            m_shift_rows = dy;
+            m_shift_cols = dx;
         }
-        ss << '\n'; 
     }
-    return ss.str();   
+    return period;
+};
+
+/**
+ * @brief Finds the generation at which a cycle starts, to the generation.
+ *
+ * With a step above 1 only every m_gen_step-th table is looked at, so a
+ * cycle is found at the first such table inside it, and the cycle really
+ * starts up to m_gen_step - 1 generations before. Table g is part of the
+ * cycle exactly when table g + period is the same (shifted, for a
+ * translating cycle), so the start is
+ * bisected over those generations, replaying the simulation for each
+ * probe: log2(m_gen_step) replays at most, none with a step of 1.
+ * @param sampled First looked at generation that is part of the cycle.
+ * @param period # of generations of the cycle, or a multiple of it.
+ * @return Generation at which the cycle starts.
+ */
+unsigned long long LifeCfg :: exact_start(unsigned long long sampled, unsigned long long period){
+    unsigned long long first = (sampled > m_gen_step) ? sampled - m_gen_step + 1 : 1;
+    unsigned long long last = sampled;
+    while (first < last){
+        const unsigned long long probe = first + (last - first) / 2;
+        long long dy, dx;
+        if (repeats(probe, period, dy, dx)){last = probe;}
+        else {first = probe + 1;}
+    }
+    return first;
 };
 
 /**
@@ -252,9 +604,11 @@ std :: string LifeCfg :: table_to_string(std :: vector<std :: vector<unsigned in
  * @param back Background color.
  * @param pixel Pixel size for images.
  * @param fps Frames per second.
+ * @param threads Number of threads that step the grid, at least 1.
  */
-void LifeCfg :: start(unsigned int gen, std :: string file, std :: string dir, std :: string cell, std :: string back, 
-unsigned int pixel, unsigned int fps){
+void LifeCfg :: start(unsigned long long gen, std :: string file, std :: string dir, std :: string cell, std :: string back, 
+unsigned int pixel, unsigned int fps, unsigned int threads){
+    m_threads = threads;
     m_fps = fps;
     m_image_dir = dir;
     m_maxgen = gen;
@@ -264,6 +618,218 @@ unsigned int pixel, unsigned int fps){
     m_pixel = pixel;
 };
 
+/**
+ * @brief Selects how the threads share the work of a generation.
+ * @param schedule "bands" (one static band of rows per thread), "tiles"
+ * (tiles dealt on per-thread deques, with work stealing) or "wavefront"
+ * (static bands that go on to the next generation as soon as their
+ * neighbors are done, with no barrier between the generations of a step).
+ */
+void LifeCfg :: set_schedule(const std :: string& schedule){
+    if (schedule != "bands" && schedule != "tiles" && schedule != "wavefront"){
+        std :: cerr << "Unknown schedule \"" << schedule << "\"!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    m_schedule = schedule;
+};
+
+/**
+ * @brief Selects the engine that steps the simulation grid.
+ * @param engine "bitboard" (bit-packed), "active" (only the cells around
+ * the last changes are evaluated), "hashlife" (memoized quadtree over the
+ * unbounded plane), "chunked" (64x64 chunks of the unbounded plane, allocated
+ * where the pattern is) or "sliced" (64 configurations per word, see run_sliced();
+ * a single one runs on the bitboard engine).
+ */
+void LifeCfg :: set_engine(const std :: string& engine){
+    if (engine != "bitboard" && engine != "active" && engine != "hashlife" && engine != "chunked" && engine != "sliced"){
+        std :: cerr << "Unknown engine \"" << engine << "\"!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    m_engine_name = engine;
+};
+
+/**
+ * @brief Selects how the edges of the simulation grid are glued together.
+ * @param boundary "torus" (both pairs of edges wrap around), "dead" (cells
+ * past the edges are dead), "klein" (columns wrap around, rows wrap around
+ * mirrored) or "cross" (both wrap around mirrored). Bounded engines only.
+ */
+void LifeCfg :: set_boundary(const std :: string& boundary){
+    if (boundary != "torus" && boundary != "dead" && boundary != "klein" && boundary != "cross"){
+        std :: cerr << "Unknown boundary \"" << boundary << "\"!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    m_boundary = boundary;
+};
+
+/**
+ * @brief Selects how the bit-packed engine computes the next states.
+ * @param kernel "adder" (bitwise full adders, 64 cells at a time), "lut"
+ * (a 512-entry table lookup per cell) or "lut16" (a 65536-entry table
+ * lookup per 2x2 block of cells).
+ */
+void LifeCfg :: set_kernel(const std :: string& kernel){
+    if (kernel != "adder" && kernel != "lut" && kernel != "lut16"){
+        std :: cerr << "Unknown kernel \"" << kernel << "\"!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    m_kernel = kernel;
+};
+
+/**
+ * @brief Caps the instruction set of the adder kernel of the bit-packed engine.
+ * @param isa "auto" (the widest the CPU supports), "avx512" (8 words at a
+ * time), "avx2" (4), "sse2" (2) or "scalar" (1). An instruction set the CPU
+ * lacks falls back to the widest one it has.
+ */
+void LifeCfg :: set_simd(const std :: string& isa){
+    if (isa != "auto" && isa != "avx512" && isa != "avx2" && isa != "sse2" && isa != "scalar"){
+        std :: cerr << "Unknown instruction set \"" << isa << "\"!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    m_simd = isa;
+};
+
+/**
+ * @brief Pins the threads that step the table, one per CPU the process may run on.
+ *
+ * Each thread then keeps its caches, and on a NUMA host the bands of the
+ * table it touched first stay on its node (see BitBoard::resize()).
+ * @param pin True to pin the threads.
+ */
+void LifeCfg :: set_pin(bool pin){
+    m_pin = pin;
+};
+
+/**
+ * @brief Backs the table of the bitboard engine with 2 MiB pages.
+ *
+ * Transparent huge pages are asked for, on Linux, for tables of at least
+ * one huge page; the kernel falls back to regular pages where it cannot.
+ * @param huge True to ask for huge pages.
+ */
+void LifeCfg :: set_huge_pages(bool huge){
+    m_huge_pages = huge;
+};
+
+/**
+ * @brief Splits the table across worker processes.
+ *
+ * Each process steps a band of rows of the table, with --threads threads,
+ * and swaps its edge rows with its neighbors through shared memory every
+ * generation (see ShardedBoard).
+ * @param shards # of processes, 1 (the table stays in this process) or more.
+ */
+void LifeCfg :: set_shards(unsigned shards){
+    if (shards < 1){
+        std :: cerr << "The # of shards must be at least 1!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    m_shards = shards;
+};
+
+/**
+ * @brief Sets the birth and survival conditions.
+ * @param rule The rule in B/S notation, e.g. "B3/S23" (Conway's) or "B36/S23" (HighLife).
+ */
+void LifeCfg :: set_rule(const std :: string& rule){
+    if (!Rule :: parse(rule, m_rule)){
+        std :: cerr << "Malformed rule \"" << rule << "\"!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+};
+
+/**
+ * @brief Selects how repeated tables are detected.
+ * @param mode "history" (every past table is kept, indexed by fingerprint)
+ * or "brent" (a single past table is kept; the simulation runs a little past
+ * the repetition, and the cycle start is found by replaying it) or
+ * "translation" (as "history", but a table also repeats when it is a past
+ * table shifted around the torus; toroidal engines only).
+ */
+void LifeCfg :: set_cycle_detect(const std :: string& mode){
+    if (mode != "history" && mode != "brent" && mode != "translation"){
+        std :: cerr << "Unknown cycle detection \"" << mode << "\"!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    m_cycle_detect = mode;
+};
+
+/**
+ * @brief Caps the memory used by the past tables of the "history" and
+ * "translation" cycle detections.
+ *
+ * The oldest tables are forgotten to stay under the cap, with a warning.
+ * @param megabytes Memory cap, in MiB (0: none).
+ */
+void LifeCfg :: set_history_mem(unsigned long long megabytes){
+    m_history.limit(static_cast<size_t>(megabytes << 20));
+    m_translations.boards().limit(static_cast<size_t>(megabytes << 20));
+    m_tile_history.limit(static_cast<size_t>(megabytes << 20));
+};
+
+/**
+ * @brief Selects how the past tables are stored.
+ * @param store "compressed" (each table bit-packed and deflate-compressed),
+ * "tiles" (each table a list of shared 64x64 tiles, so the tiles that did
+ * not change are not stored again; toroidal engines and the "history" cycle
+ * detection only) or "auto" (tiles for the bitboard and active engines and
+ * the "history" cycle detection, compressed otherwise).
+ */
+void LifeCfg :: set_history_store(const std :: string& store){
+    if (store != "auto" && store != "compressed" && store != "tiles"){
+        std :: cerr << "Unknown history store \"" << store << "\"!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    m_history_store = store;
+};
+
+/**
+ * @brief Selects what happens once a cycle is found.
+ * @param mode "stop" (end the simulation), "fast-forward" (jump straight to
+ * the last generation, simulating at most one period) or "replay" (keep
+ * showing generations, taken from the recorded period of the cycle).
+ */
+void LifeCfg :: set_on_cycle(const std :: string& mode){
+    if (mode != "stop" && mode != "fast-forward" && mode != "replay"){
+        std :: cerr << "Unknown action on cycle \"" << mode << "\"!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    m_on_cycle = mode;
+};
+
+/**
+ * @brief Sets how many generations each update advances.
+ * @param step # of generations (at least 1).
+ */
+void LifeCfg :: set_gen_step(unsigned long long step){
+    m_gen_step = std :: max(1ULL, step);
+};
+
+/**
+ * @brief Sets how many generations the bitboard engine advances per pass
+ * over the table (temporal blocking). Only updates of several generations
+ * (see set_gen_step()) gain from it.
+ * @param depth # of generations per pass, 1 to 64.
+ */
+void LifeCfg :: set_temporal(unsigned depth){
+    if (depth < 1 || depth > BitBoard :: tile_rows){
+        std :: cerr << "Temporal blocking depth must be between 1 and " << BitBoard :: tile_rows << "!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    m_temporal = depth;
+};
+
+/**
+ * @brief Keeps the simulation off the standard output.
+ *
+ * Only the messages on the standard error are kept, so several simulations
+ * can share a process (see `--batch`) and report just their endings.
+ * @param quiet True to print nothing.
+ */
+void LifeCfg :: set_quiet(bool quiet){m_quiet = quiet;};
+
 /**
  * @brief Displays a welcome message at the start of the simulation.
  */
@@ -274,6 +840,7 @@ void LifeCfg :: display_welcome(void) const{
     std :: cout << ">>> Grid size read from input file: " << m_rows << " rows by "<< m_cols <<" cols." << std :: endl;
     std :: cout << ">>> Character that represents a living cell read from input file: '*' " << std :: endl;
     std :: cout << ">>> Finished reading input data file." << std :: endl;
+    if (m_rule != Rule()){std :: cout << ">>> Rule: " << m_rule.name() << " instead of Conway's B3/S23." << std :: endl;}
     std :: cout << std :: endl;
     std :: cout << "********************************************************************" << std :: endl;
     std :: cout << std :: endl;
@@ -288,77 +855,180 @@ void LifeCfg :: display_welcome(void) const{
 
 /**
  * @brief Updates the simulation grid to the next generation.
+ *
+ * Advances `m_gen_step` generations at once (never past `m_maxgen`), which
+ * lets the HashLife engine jump over billions of generations per update.
+ * The current table is looked up in the history by its fingerprint, so
+ * detecting stability costs O(1) per generation instead of a scan over
+ * every past table. Once a cycle is found, the simulation stops, jumps
+ * straight to the last generation shown before `m_maxgen`, or replays the
+ * cycle, depending on `m_on_cycle`.
  */
 void LifeCfg :: update_gen(void){
-    m_n_gen++;
-    std :: string old_table = table_to_string(m_table);
-    if (compare(m_old_tables, old_table)){
+    if (m_jumped){
         m_stop = true;
+        return;
+    }
+    unsigned long long gen = m_n_gen;
+    unsigned long long advance = m_gen_step;
+    if (m_maxgen > m_n_gen){advance = std :: min(advance, m_maxgen - m_n_gen);}
+    m_n_gen += advance;
+    if (m_frames.empty() && find_cycle(gen)){
         m_ending = ending_e :: STABILITY;
+        // A jump only pays off if a normal run would still show a later generation.
+        if (m_on_cycle == "fast-forward" && m_maxgen > m_n_gen){
+            fast_forward(gen);
+            return;
+        }
+        else if (m_on_cycle == "replay"){cache_cycle(gen);}
+        else {m_stop = true;}
     }
     if (m_n_gen == m_maxgen){
         m_stop = true;
         m_ending = ending_e :: MAXGEN;
     }
-    if (all_dead(old_table)){
+    if (m_table->population() == 0){
         m_stop = true;
         m_ending = ending_e :: EXTINCTION;
     }
-    m_old_tables.push_back(old_table);
-    std :: vector<vector<unsigned int>> temp_table = m_table;
-    for (unsigned int i = 0; i < m_rows; i++){
-        for (unsigned int j = 0; j < m_cols; j++){
-            if (set_alive(temp_table, i, j, temp_table[i][j])){m_table[i][j] = 1;}
-            else {m_table[i][j] = 0;}
+    if (!m_frames.empty()){load_frame(m_n_gen);}
+    else {m_table->step(advance);}
+};
+
+/**
+ * @brief Looks the current table up among the past ones.
+ * @param gen Generation of the current table.
+ * @return True if the table repeats; the cycle members then describe it.
+ */
+bool LifeCfg :: find_cycle(unsigned long long gen){
+    // Unbounded engines may have cells outside of the window: they fingerprint the whole plane.
+    if (m_cycle_detect == "brent"){
+        unsigned long long period;
+        if (!m_brent.find(*m_table, (gen - 1) / m_gen_step, period)){return false;}
+        const unsigned long long sampled = cycle_start(period * m_gen_step);
+        m_period = exact_period(sampled, period * m_gen_step);
+        m_cycle_start = exact_start(sampled, m_period);
+        return true;
+    }
+    unsigned long long seen = gen;
+    bool found;
+    unsigned long long evicted, oldest;
+    if (m_history_store == "tiles"){
+        found = m_tile_history.insert(*m_table, seen);
+        evicted = m_tile_history.evicted();
+        oldest = m_tile_history.oldest();
+    }
+    else {
+        History :: snapshot_t snapshot;
+        m_table->snapshot(snapshot);
+        if (m_cycle_detect == "translation"){
+            found = m_translations.insert(seen, snapshot, m_shift_rows, m_shift_cols);
         }
+        else {
+            uint64_t fingerprint = m_table->fingerprint();
+            found = m_history.find(fingerprint, snapshot, seen);
+            if (!found){m_history.insert(fingerprint, gen, snapshot);}
+        }
+        const History& past = (m_cycle_detect == "translation") ? m_translations.boards() : m_history;
+        evicted = past.evicted();
+        oldest = past.oldest();
+    }
+    if (evicted > 0 && !m_history_warned){
+        std :: cerr << "Warning: history memory limit reached; tables before generation " << oldest
+                    << " are forgotten, so longer cycles go undetected." << std :: endl;
+        m_history_warned = true;
     }
+    if (!found){return false;}
+    m_period = exact_period(seen, gen - seen);
+    m_cycle_start = exact_start(seen, m_period);
+    return true;
 };
 
 /**
- * @brief Determines if a cell will live, die, or be born based on game rules.
- * @param table Current simulation grid.
- * @param row Row index of the cell.
- * @param col Column index of the cell.
- * @param cell Current state of the cell (alive or dead).
- * @return True if the cell will be alive in the next generation, false otherwise.
- */ 
-bool LifeCfg :: set_alive(const std :: vector<std :: vector<unsigned int>> table, unsigned int row, unsigned int col, unsigned int cell){
-    int n_alives = 0;
-    bool alive = false;
-
-    // Obtém o número de linhas e colunas da matriz
-    size_t rows = table.size();
-    size_t cols = table[0].size();
-
-    // Verifica células vizinhas de acordo com a posição (row, col)
-    for (int cell_row = -1; cell_row <= 1; ++cell_row) {
-        for (int cell_col = -1; cell_col <= 1; ++cell_col) {
-            if (cell_row == 0 && cell_col == 0) continue; // Ignora a célula atual
-
-            int neighbor_row = row + cell_row;
-            int neighbor_col = col + cell_col;
-
-            if (neighbor_row < 0) neighbor_row = rows - 1;
-            if (static_cast<size_t>(neighbor_row) >= rows) neighbor_row = 0;
-            if (neighbor_col < 0) neighbor_col = cols - 1;
-            if (static_cast<size_t>(neighbor_col) >= cols) neighbor_col = 0;
-
-            if (table[neighbor_row][neighbor_col] == 1) {
-                ++n_alives;
-            }
+ * @brief Copies the cells of the window, 64 per word, row after row.
+ * @param frame Receives rows() * ceil(cols() / 64) words.
+ */
+void LifeCfg :: capture(History :: snapshot_t& frame) const{
+    const size_t words = (m_cols + 63) / 64;
+    frame.assign(m_rows * words, 0);
+    for (size_t i = 0; i < m_rows; i++){
+        for (size_t j = 0; j < m_cols; j++){
+            if (m_table->get(i, j)){frame[i * words + j / 64] |= uint64_t(1) << (j % 64);}
         }
     }
+};
 
-    if (cell == 1) { 
-        if (n_alives == 2 || n_alives == 3) {alive = true;} 
-        else {alive = false;}
-    } 
-    else { 
-        if (n_alives == 3) {alive = true;} 
-        else {alive = false;}
+/**
+ * @brief Writes a captured window back into the table.
+ *
+ * The cells are shifted by the displacement of the given # of cycles, so
+ * translating cycles keep moving. Only the cells that differ are set.
+ * @param frame Captured window.
+ * @param cycles # of cycles elapsed since the frame was captured.
+ */
+void LifeCfg :: restore(const History :: snapshot_t& frame, unsigned long long cycles){
+    const size_t words = (m_cols + 63) / 64;
+    const long long rows = m_rows;
+    const long long cols = m_cols;
+    // The shift is reduced before multiplying, so huge # of cycles cannot overflow.
+    const size_t dy = static_cast<size_t>((static_cast<long long>(cycles % m_rows) * ((m_shift_rows % rows + rows) % rows)) % rows);
+    const size_t dx = static_cast<size_t>((static_cast<long long>(cycles % m_cols) * ((m_shift_cols % cols + cols) % cols)) % cols);
+    for (size_t i = 0; i < m_rows; i++){
+        const size_t from_i = (i + m_rows - dy) % m_rows;
+        for (size_t j = 0; j < m_cols; j++){
+            const size_t from_j = (j + m_cols - dx) % m_cols;
+            bool alive = (frame[from_i * words + from_j / 64] >> (from_j % 64)) & 1;
+            if (m_table->get(i, j) != alive){m_table->set(i, j, alive);}
+        }
+    }
+};
+
+/**
+ * @brief Moves the table straight to the last generation a normal run shows.
+ *
+ * A normal run shows gen, gen + step, ... and stops before `m_maxgen`, so
+ * the target is the last of them below `m_maxgen`. It shows the same cells
+ * as generation gen + (target - gen) mod period, shifted by one
+ * displacement per skipped cycle, so at most one period is simulated.
+ * @param gen Generation of the current table, which is part of the cycle.
+ */
+void LifeCfg :: fast_forward(unsigned long long gen){
+    const unsigned long long target = gen + (m_maxgen - 1 - gen) / m_gen_step * m_gen_step;
+    const unsigned long long remainder = (target - gen) % m_period;
+    m_table->step(remainder);
+    const unsigned long long cycles = (target - gen) / m_period;
+    if (cycles > 0 && (m_shift_rows != 0 || m_shift_cols != 0)){
+        History :: snapshot_t frame;
+        capture(frame);
+        restore(frame, cycles);
     }
+    m_n_gen = target;
+    m_jumped = true;
+};
 
-    return alive;
+/**
+ * @brief Records the tables of one period of the cycle.
+ * @param gen Generation of the current table, the first one recorded.
+ */
+void LifeCfg :: cache_cycle(unsigned long long gen){
+    // The tables shown repeat once both the cycle and the step have come around.
+    m_frames.resize(std :: lcm(m_period, m_gen_step) / m_gen_step);
+    for (auto& frame : m_frames){
+        capture(frame);
+        m_table->step(m_gen_step);
+    }
+    m_frames_gen = gen;
+};
+
+/**
+ * @brief Shows a generation of the cycle, from the recorded tables.
+ * @param gen Generation to show.
+ */
+void LifeCfg :: load_frame(unsigned long long gen){
+    const unsigned long long elapsed = gen - m_frames_gen;
+    const unsigned long long frame = elapsed / m_gen_step % m_frames.size();
+    // The frame was captured frame * m_gen_step generations in, so it is shifted by the cycles since then.
+    restore(m_frames[frame], (elapsed - frame * m_gen_step) / m_period);
 };
 
 /**
@@ -369,7 +1039,7 @@ void LifeCfg :: display_conway(void) const{
     for (unsigned int i = 0; i < m_rows; i++){
         std :: cout << "[";
         for (unsigned int j = 0; j < m_cols; j++){
-            if (m_table[i][j] == 1){
+            if (m_table->get(i, j)){
                 std :: cout << "*";
             }
             else {std :: cout << " ";}
@@ -385,11 +1055,10 @@ void LifeCfg :: display_conway(void) const{
 void LifeCfg :: make_words(std :: string& filename){
     static const char letras[] = "abcdefghijklmnopqrstuvwxyz"; 
     int tamLetras = sizeof(letras) - 1;
-    static int counter = 0;
     std :: string word = "";
     for (int i = 0; i < 3; ++i) {
-      word += letras[counter % tamLetras];
-      counter++;
+      word += letras[m_words % tamLetras];
+      m_words++;
     }
     m_file_path = filename + "/" + word;
 };
@@ -410,30 +1079,75 @@ void LifeCfg :: display_end(void) const{
             break;
         case ending_e :: MAXGEN:
             std :: cout << "The informed generation limit has been reached.";
+            // Brent's algorithm lags behind the cycle, so the verdict may differ from "history".
+            if (m_cycle_detect == "brent"){
+                std :: cout << std :: endl << "Brent's algorithm confirms a cycle some generations after it comes around:"
+                            << " one that came around shortly before the limit is not reported.";
+            }
             break;
         case ending_e :: UNDEFINED:
             break;        
     }
+    if (m_period > 0){
+        std :: cout << std :: endl << "Cycle of period " << m_period << ", first seen at generation " << m_cycle_start << ".";
+        if (m_cycle_detect == "brent"){
+            std :: cout << std :: endl << "It came around at generation " << m_cycle_start + m_period
+                        << "; Brent's algorithm confirmed it later.";
+        }
+        if (m_shift_rows != 0 || m_shift_cols != 0){
+            std :: cout << std :: endl << "Displacement per cycle: " << m_shift_rows << " row(s), " << m_shift_cols << " column(s) (positive: down, right).";
+        }
+        if (m_jumped){std :: cout << std :: endl << "Fast-forwarded to generation " << m_last_gen << ".";}
+        if (!m_frames.empty()){std :: cout << std :: endl << "Generations after " << m_frames_gen << " were replayed from the cycle.";}
+    }
     std :: cout << std :: endl;
     std :: cout << std :: endl;
     std :: cout << "********************************" << std :: endl;
 };
 
 /**
- * @brief Paints the simulation grid into a Canvas object.
+ * @brief Paints the simulation grid into the canvas.
+ *
+ * The canvas keeps the previous frame, so with an engine that stamps its
+ * tiles only the tiles changed since that frame are read and painted
+ * again; other engines, and the first frame, are painted in full. The
+ * canvas is made by the first frame, so runs that save no image need none.
  * @param table Current simulation grid.
- * @param canvas Canvas object where the grid will be painted.
- */
-void LifeCfg :: paint_pixel(std :: vector<std :: vector<unsigned int>>& table, Canvas& canvas){
-    size_t row = table.size();
-    size_t col = table[0].size();
-    for (size_t i = 0; i < row; i++){
-        for (size_t j = 0; j < col; j++){
-            if (table[i][j] == 1){canvas.pixel(j, i, color_pallet[m_cell_color]);}
-            else if(table[i][j] == 0){canvas.pixel(j, i, color_pallet[m_back_color]);}
-            
+ */
+void LifeCfg :: paint_pixel(const Engine& table){
+    if (m_canvas == nullptr){
+        m_canvas.reset(new Canvas(static_cast<size_t>(m_cols), static_cast<size_t>(m_rows), static_cast<short>(m_pixel)));
+        m_painted = false;
+    }
+    const size_t side = table.tile_size() != 0 ? table.tile_size() : 64;
+    const size_t words = side / 64;
+    const bool stamped = m_painted && table.tile_size() != 0;
+    // Unknown color names paint black, as they always did.
+    auto color = [](const string& name){
+        auto found = color_pallet.find(name);
+        return (found == color_pallet.end()) ? BLACK : found->second;
+    };
+    const Color alive = color(m_cell_color);
+    const Color dead = color(m_back_color);
+    const size_t rows = table.rows();
+    const size_t cols = table.cols();
+    std :: vector<uint64_t> cells(side * words);
+    for (size_t tr = 0; tr * side < rows; tr++){
+        for (size_t tc = 0; tc * side < cols; tc++){
+            if (stamped && table.tile_stamp(tr, tc) <= m_painted_epoch){continue;}
+            table.read_tile(tr, tc, side, cells.data());
+            const size_t row_end = std :: min(side, rows - tr * side);
+            const size_t col_end = std :: min(side, cols - tc * side);
+            for (size_t i = 0; i < row_end; i++){
+                for (size_t j = 0; j < col_end; j++){
+                    const bool on = (cells[i * words + j / 64] >> (j % 64)) & 1;
+                    m_canvas->pixel(tc * side + j, tr * side + i, on ? alive : dead);
+                }
+            }
         }
-    }  
+    }
+    m_painted = true;
+    m_painted_epoch = table.epoch();
 };
 
-}  // namespace life
\ No newline at end of file
+}  // namespace life
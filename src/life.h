@@ -16,12 +16,19 @@
 #include <cassert>
 #include <cstring>  // std::memcpy().
 #include <iostream>
+#include <memory>
 #include <set>
 #include <sstream>  // std::ostringstream
 #include <stdexcept>
 #include <string>
 #include <vector>
 #include "common.h"
+#include "bitboard.h"
+#include "engine.h"
+#include "history.h"
+#include "brent.h"
+#include "translation_history.h"
+#include "tile_history.h"
 
 using std::cerr;
 using std::cout;
@@ -56,20 +63,52 @@ class LifeCfg {
     bool m_stop;                            //!< Flag to check if the conway ends.
     bool m_extinct;                         //!< Flag to check if a cell will die.
     bool m_exit;                            //!< Flag to end the program.
-    unsigned int m_n_gen = 1;               //!< # of current generation.
+    unsigned long long m_n_gen = 1;         //!< # of current generation.
+    unsigned long long m_last_gen;          //!< # of the last generation shown.
     unsigned int m_cols;                    //!< # of colums.
     unsigned int m_rows;                    //!< # of rows.
-    unsigned int m_maxgen;                  //!< Max number of generations.
+    unsigned long long m_maxgen;            //!< Max number of generations.
+    unsigned long long m_gen_step;          //!< # of generations advanced per update.
+    unsigned m_temporal;                    //!< # of generations the bitboard engine advances per pass over the table.
     unsigned int m_fps;                     //!< # of generations presented p/ second.
     unsigned int m_pixel;
+    unsigned int m_threads;                 //!< # of threads that step the table.
+    string m_schedule;                      //!< How threads share a generation (bands, tiles, wavefront).
+    string m_engine_name;                   //!< Engine that steps the table (bitboard, active, hashlife, chunked, sliced).
+    string m_boundary;                      //!< How the edges of the table are glued (torus, dead, klein, cross).
+    string m_kernel;                        //!< How the bitboard engine computes a generation (adder, lut, lut16).
+    string m_simd;                          //!< Widest instruction set of the adder kernel (auto, avx512, avx2, sse2, scalar).
+    bool m_pin;                             //!< Flag to pin the threads that step the table to CPUs of their own.
+    bool m_huge_pages;                      //!< Flag to back the bitboard engine's table with huge pages.
+    unsigned m_shards;                      //!< # of worker processes the table is split across (1: none).
+    Rule m_rule;                            //!< Birth and survival conditions.
     string m_back_color;                    //!< Dead cell color.
     string m_cell_color;                    //!< Alive cell color.
     string m_txt_file;                      //!< Txt file name.
     string m_image_dir;                     //!< Image directory name.
     string m_file_path;                     //!< Image file.
-    vector<vector<unsigned int>> m_table;   //!< Conways table.
-    vector<string> m_old_tables;            //!< Tables already made.
-    Canvas m_canvas;                        //!< Canvas object
+    unsigned int m_words;                   //!< # of letters used so far by make_words().
+    bool m_quiet;                           //!< Flag to keep the tables and messages off the output.
+    std::unique_ptr<Engine> m_table;        //!< Conways table and the engine that steps it.
+    string m_cycle_detect;                  //!< How repeated tables are detected (history, brent, translation).
+    History m_history;                      //!< Tables already made.
+    bool m_history_warned;                  //!< Flag to check if the history limit was reported.
+    string m_history_store;                 //!< How past tables are stored (auto, compressed, tiles).
+    TileHistory m_tile_history;             //!< Tables already made, as shared tiles, for "tiles".
+    Brent m_brent;                          //!< Constant-memory detector, for "brent".
+    TranslationHistory m_translations;      //!< Tables already made, up to translation, for "translation".
+    unsigned long long m_cycle_start;       //!< Generation at which the repeating cycle starts.
+    unsigned long long m_period;            //!< # of generations of the repeating cycle.
+    long long m_shift_rows;                 //!< # of rows the table moves down each cycle.
+    long long m_shift_cols;                 //!< # of columns the table moves right each cycle.
+    string m_on_cycle;                      //!< What to do once a cycle is found (stop, fast-forward, replay).
+    bool m_jumped;                          //!< Flag to check if the table was fast-forwarded to its last generation.
+    vector<History::snapshot_t> m_frames;   //!< Windows of one period of the cycle, for "replay".
+    unsigned long long m_frames_gen;        //!< Generation of m_frames[0].
+    std::unique_ptr<Canvas> m_canvas;       //!< Canvas holding the last frame painted, made by the first frame saved.
+    bool m_painted;                         //!< Flag to check if m_canvas holds a frame of m_table.
+    unsigned long long m_painted_epoch;     //!< Engine epoch of the frame in m_canvas.
+    std::unique_ptr<ThreadPool> m_pool;     //!< Workers, when m_threads > 1.
 
 
     public:
@@ -78,6 +117,9 @@ class LifeCfg {
     
     //!< Update the conway.
     void update(void);
+
+    //!< Runs up to 64 configurations of the same size and options to their end at once, with the sliced engine.
+    static void run_sliced(const vector<LifeCfg*>& pack);
     
     //!< Returns true if the cell will be extinguished.
     bool extinct(void) const; 
@@ -89,11 +131,14 @@ class LifeCfg {
     unsigned int cols(void) const; 
 
     //!< Returns the max of generations.
-    unsigned int max_gen(void) const;
+    unsigned long long max_gen(void) const;
 
     //!< Returns the fps.
     unsigned int fps(void) const;
 
+    //!< Returns the # of threads that step the table.
+    unsigned int threads(void) const;
+
     //!< Return the pixel_size.
     unsigned int pixel_size(void) const;
 
@@ -110,34 +155,112 @@ class LifeCfg {
     std :: string& image_dir(void);
 
     //!< Returns the table.
-    vector<vector<unsigned int>> table(void) const;
-
-    //!< Returns the tables already made.
-    vector<string> old_tables(void) const;
-    
-    //!< Returns true if conway has already been registered.
-    bool compare(vector<string> olds, string table);
-
-    //!< Returns true if all cells are dead.
-    bool all_dead(string table);
+    const Engine& table(void) const;
 
     //!< Return true if is the end of conway.
     bool exit_conway() const;
+
+    //!< Returns the cause of conway's end ("extinction", "maxgen", "stability" or "undefined").
+    string ending(void) const;
+
+    //!< Returns the # of the last generation shown.
+    unsigned long long generation(void) const;
+
+    //!< Returns the # of generations of the repeating cycle (0: none found).
+    unsigned long long period(void) const;
     
-    //!< Reads the file with columns, rows, and starting cell locations.
-    void read_file(void); 
+    //!< Reads the # of rows and columns and the alive cell character of a configuration; throws std::runtime_error if invalid.
+    static void read_header(std::istream& file, size_t& rows, size_t& cols, char& alive);
+
+    //!< Reads the file with columns, rows, and starting cell locations into a new engine; throws std::runtime_error on a bad file.
+    std::unique_ptr<Engine> read_file(void);
 
-    //!< Transforms a table into a string.
-    string table_to_string(vector<vector<unsigned int>>&);
+    //!< Returns the topology named by m_boundary.
+    boundary_e boundary_mode(void) const;
+
+    //!< Returns the generation at which a cycle of the given period starts.
+    unsigned long long cycle_start(unsigned long long period);
+
+    //!< Returns true if table gen + distance is the same as table gen (shifted by dy and dx, for "translation"), by replaying the simulation.
+    bool repeats(unsigned long long gen, unsigned long long distance, long long& dy, long long& dx);
+
+    //!< Reduces a multiple of the period of a cycle to the period itself.
+    unsigned long long exact_period(unsigned long long sampled, unsigned long long distance);
+
+    //!< Narrows the first looked at generation of a cycle down to the generation where it starts.
+    unsigned long long exact_start(unsigned long long sampled, unsigned long long period);
 
     //!< Starts the object with its members provided in the imput.
-    void start(unsigned int generations, string file, string dir, string cell, string back, unsigned int pixel, unsigned int fps);
+    void start(unsigned long long generations, string file, string dir, string cell, string back, unsigned int pixel, unsigned int fps, unsigned int threads = 1);
+
+    //!< Selects how threads share a generation ("bands" or "tiles").
+    void set_schedule(const string& schedule);
+
+    //!< Selects the engine that steps the table ("bitboard", "active", "hashlife", "chunked" or "sliced").
+    void set_engine(const string& engine);
+
+    //!< Selects how the edges of the table are glued ("torus", "dead", "klein" or "cross").
+    void set_boundary(const string& boundary);
+
+    //!< Selects how repeated tables are detected ("history", "brent" or "translation").
+    void set_cycle_detect(const string& mode);
+
+    //!< Caps the memory of the past tables, in MiB (0: no cap).
+    void set_history_mem(unsigned long long megabytes);
+
+    //!< Selects how the past tables are stored ("auto", "compressed" or "tiles").
+    void set_history_store(const string& store);
+
+    //!< Selects what happens once a cycle is found ("stop", "fast-forward" or "replay").
+    void set_on_cycle(const string& mode);
+
+    //!< Selects how the bitboard engine computes a generation ("adder", "lut" or "lut16").
+    void set_kernel(const string& kernel);
+
+    //!< Caps the instruction set of the adder kernel ("auto", "avx512", "avx2", "sse2" or "scalar").
+    void set_simd(const string& isa);
+
+    //!< Pins the threads that step the table to CPUs of their own.
+    void set_pin(bool pin);
+
+    //!< Backs the table of the bitboard engine with huge pages, if it fills one.
+    void set_huge_pages(bool huge);
+
+    //!< Splits the table across worker processes, by bands of rows.
+    void set_shards(unsigned shards);
+
+    //!< Sets the rule, in B/S notation (e.g. "B36/S23").
+    void set_rule(const string& rule);
+
+    //!< Sets the # of generations advanced per update.
+    void set_gen_step(unsigned long long step);
+
+    //!< Sets the # of generations the bitboard engine advances per pass over the table (1 to 64).
+    void set_temporal(unsigned depth);
+
+    //!< Keeps the welcome, the tables and the farewell off the standard output.
+    void set_quiet(bool quiet);
 
     //!< Update the table to the next gen.
     void update_gen(void);
 
-    //!< Check if the cell will die, live or be born. 
-    bool set_alive(const vector<vector<unsigned int>> table, unsigned int row, unsigned int col, unsigned int cell);
+    //!< Returns true if the table of the given generation repeats a past one.
+    bool find_cycle(unsigned long long gen);
+
+    //!< Copies the window of the table.
+    void capture(History::snapshot_t& frame) const;
+
+    //!< Writes a copied window into the table, shifted by the given # of cycles.
+    void restore(const History::snapshot_t& frame, unsigned long long cycles);
+
+    //!< Moves the table, part of a cycle, straight to the last generation.
+    void fast_forward(unsigned long long gen);
+
+    //!< Records one period of the cycle, starting at the current table.
+    void cache_cycle(unsigned long long gen);
+
+    //!< Shows the given generation from the recorded period.
+    void load_frame(unsigned long long gen);
 
     //!< Make words.
     void make_words(string& filename);
@@ -151,8 +274,8 @@ class LifeCfg {
     //!< Display the farewell.
     void display_end(void) const;
 
-    //!< Paint the pixel.
-    void paint_pixel(vector<vector<unsigned int>>& table, Canvas& canvas);
+    //!< Paints the cells of the table changed since the last frame into m_canvas.
+    void paint_pixel(const Engine& table);
 
 };
 
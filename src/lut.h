@@ -0,0 +1,65 @@
+//! Lookup tables of the next state of small blocks of cells.
+/*!
+ * @file lut.h
+ *
+ * @details Tables used by the lookup-table kernels of BitBoard. The tables
+ * of Conway's rule are generated at compile time; the same functions build
+ * the tables of other rules at run time.
+ */
+
+#ifndef _LUT_H_
+#define _LUT_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace life {
+
+/// Returns the # of set bits of a 16-bit value.
+constexpr unsigned popcount16(unsigned x){
+    x = x - ((x >> 1) & 0x5555);
+    x = (x & 0x3333) + ((x >> 2) & 0x3333);
+    x = (x + (x >> 4)) & 0x0f0f;
+    return (x + (x >> 8)) & 0x1f;
+}
+
+/// Returns the next state of a cell, given a block and the masks of the cell and of its neighbors in it.
+constexpr unsigned next_cell(unsigned block, unsigned cell, unsigned neighbors, uint16_t birth, uint16_t survive){
+    const unsigned alives = popcount16(block & neighbors);
+    return ((((block & cell) != 0) ? survive : birth) >> alives) & 1;
+}
+
+/// Builds the table of the next state of the center of every 3x3 neighborhood.
+/*!
+ * Bit 3 * row + col of the index is cell (row, col) of the neighborhood,
+ * so the center is bit 4.
+ */
+constexpr std::array<uint8_t, 512> make_lut3x3(uint16_t birth, uint16_t survive){
+    std::array<uint8_t, 512> table{};
+    for (unsigned i = 0; i < 512; i++){table[i] = static_cast<uint8_t>(next_cell(i, 0x010, 0x1ef, birth, survive));}
+    return table;
+}
+
+/// Builds the table of the next 2x2 center of every 4x4 block.
+/*!
+ * Bit 4 * row + col of the index is cell (row, col) of the block. Bit
+ * 2 * row + col of an entry is the next state of cell (row + 1, col + 1).
+ */
+constexpr std::array<uint8_t, 65536> make_lut4x4(uint16_t birth, uint16_t survive){
+    std::array<uint8_t, 65536> table{};
+    for (unsigned i = 0; i < 65536; i++){
+        table[i] = static_cast<uint8_t>(next_cell(i, 0x0020, 0x0757, birth, survive)
+                                      | next_cell(i, 0x0040, 0x0eae, birth, survive) << 1
+                                      | next_cell(i, 0x0200, 0x7570, birth, survive) << 2
+                                      | next_cell(i, 0x0400, 0xeae0, birth, survive) << 3);
+    }
+    return table;
+}
+
+inline constexpr std::array<uint8_t, 512> lut3x3 = make_lut3x3(0x008, 0x00c);       //!< Next state of a 3x3 center, B3/S23.
+inline constexpr std::array<uint8_t, 65536> lut4x4 = make_lut4x4(0x008, 0x00c);     //!< Next 2x2 center of a 4x4 block, B3/S23.
+
+}  // namespace life
+
+#endif
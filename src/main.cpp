@@ -20,20 +20,55 @@
 
 #include <cstdlib>  // EXIT_SUCCESS
 #include <iostream>
+#include <fstream>
 #include <string.h>
+#include <atomic>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <thread>
+#include <vector>
 #include "life.h"
+#include "sliced_boards.h"
+#include "thread_pool.h"
 #include <cctype>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
 
 
+/// Most threads, concurrent jobs or shards an option may ask for, whatever the host.
+static constexpr unsigned long long max_workers = 1024;
+
 //Struct that contains the options provided by the user. 
 struct RunningOpt {
-    unsigned int generations;   //!<Max number of generations.
+    unsigned long long generations; //!<Max number of generations.
     std :: string cell_color;   //!<Color to show the cell.
     std :: string back_color;   //!<Background color.
     size_t pixel_size;    //!<Pixel size of a square cell.
     unsigned int fps;           //!<# of generations presented p/ second.
     std :: string file_name;    //!<Name of the file that contains the beginning of the game. 
+    std :: vector<std :: string> files; //!<Every input file, in the order given.
+    bool batch;                 //!<Flag to run every input file as an independent job.
+    unsigned int jobs;          //!<# of input files simulated at once, in batch mode.
     std :: string image_dir;    //!<Name of the file that the png`s will be saved.
+    unsigned int threads;       //!<# of threads that step the board.
+    std :: string schedule;     //!<How threads share a generation.
+    std :: string engine;       //!<Engine that steps the board.
+    std :: string kernel;       //!<How the bitboard engine computes a generation.
+    std :: string simd;         //!<Widest instruction set of the adder kernel.
+    bool pin;                   //!<Flag to pin the threads that step the board to CPUs of their own.
+    bool huge_pages;            //!<Flag to back large boards with huge pages.
+    unsigned shards;            //!<# of worker processes the board is split across.
+    std :: string boundary;     //!<How the edges of the board are glued together.
+    std :: string rule;         //!<Birth and survival conditions, in B/S notation.
+    unsigned long long step;    //!<# of generations advanced per update.
+    unsigned temporal;          //!<# of generations advanced per pass over the board.
+    std :: string cycle_detect; //!<How repeated boards are detected.
+    std :: string on_cycle;     //!<What to do once a cycle is found.
+    unsigned long long history_mem; //!<Memory cap of the past boards, in MiB.
+    std :: string history_store;    //!<How the past boards are stored.
 };
 
 /*!
@@ -42,6 +77,7 @@ struct RunningOpt {
  */
 void help_message(){
     std :: cout << "Usage: glife [options] input_cfg_file" << std :: endl;
+    std :: cout << "       glife [options] --batch input_cfg_file..." << std :: endl;
     std :: cout << "Running options:" << std :: endl;
     std :: cout << "    --help Print this help text." << std :: endl;
     std :: cout << "    --maxgen <num> Maximum number of generations to simulate. No default." << std :: endl;
@@ -50,12 +86,77 @@ void help_message(){
     std :: cout << "    --blocksize <num> Pixel size of a square cell. Default = 5." << std :: endl;
     std :: cout << "    --bkgcolor <color> Color name for the background. Default = GREEN." << std :: endl;
     std :: cout << "    --alivecolor <color> Color name for the alive cells. Default = RED." << std :: endl;
+    std :: cout << "    --threads <num> # of threads that step the board, up to 1024. Default = 1." << std :: endl;
+    std :: cout << "    --schedule <bands|tiles|wavefront> Static row bands, tiles with work stealing, or row bands" << std :: endl;
+    std :: cout << "             that each go on to the next generation as soon as their neighbors are done" << std :: endl;
+    std :: cout << "             (with --step above 1). Default = bands." << std :: endl;
+    std :: cout << "    --engine <bitboard|active|hashlife|chunked|sliced> Bit-packed board, board evaluating only active" << std :: endl;
+    std :: cout << "             cells, HashLife on the unbounded plane, 64x64 chunks of the unbounded plane allocated" << std :: endl;
+    std :: cout << "             where the pattern is, or (with --batch) up to 64 input files of the same" << std :: endl;
+    std :: cout << "             size stepped at once, one per bit. Default = bitboard." << std :: endl;
+    std :: cout << "    --kernel <adder|lut|lut16> Bitboard kernel: bitwise adders, a lookup per cell," << std :: endl;
+    std :: cout << "             or a lookup per 2x2 cells. Default = adder." << std :: endl;
+    std :: cout << "    --simd <auto|avx512|avx2|sse2|scalar> Widest instruction set of the adder kernel; the CPU is" << std :: endl;
+    std :: cout << "             asked at startup, and sets it lacks fall back to narrower ones. Default = auto." << std :: endl;
+    std :: cout << "    --pin Pin the threads that step the board to CPUs of their own, so the rows each one" << std :: endl;
+    std :: cout << "             zeroes first (and then steps) stay on its NUMA node." << std :: endl;
+    std :: cout << "    --hugepages Back boards of at least 2 MiB with huge pages (Linux transparent huge pages)." << std :: endl;
+    std :: cout << "    --shards <num> Split the board across this many worker processes, by bands of rows that swap" << std :: endl;
+    std :: cout << "             their edge rows through shared memory every generation. Default = 1 (no split)." << std :: endl;
+    std :: cout << "    --boundary <torus|dead|klein|cross> Edges wrap around, are dead, or wrap around mirrored" << std :: endl;
+    std :: cout << "             (rows only for a Klein bottle, both for a cross-surface). Default = torus." << std :: endl;
+    std :: cout << "    --rule <B../S..> Life-like rule, e.g. B36/S23 (HighLife). Default = B3/S23." << std :: endl;
+    std :: cout << "    --step <num> # of generations advanced between two displayed generations. Default = 1." << std :: endl;
+    std :: cout << "    --temporal <num> Bitboard generations advanced per pass over the board, band by band in cache" << std :: endl;
+    std :: cout << "             (1 to 64, at most --step). Default = 1." << std :: endl;
+    std :: cout << "    --cycle-detect <history|brent|translation> Keep every past board, only one (Brent's algorithm)," << std :: endl;
+    std :: cout << "             or every past board, also matching them shifted around the torus." << std :: endl;
+    std :: cout << "             Brent's algorithm confirms a cycle some generations after it comes around, so it may" << std :: endl;
+    std :: cout << "             end later than history, or at --maxgen if the cycle comes around shortly before it." << std :: endl;
+    std :: cout << "             Also accepted as --cycle-detect=<mode>. Default = history." << std :: endl;
+    std :: cout << "    --history-mem <MiB> Memory cap of the past boards; the oldest are forgotten. Default = 0 (no cap)." << std :: endl;
+    std :: cout << "    --history-store <auto|compressed|tiles> Past boards deflate-compressed, or as shared 64x64 tiles" << std :: endl;
+    std :: cout << "             (unchanged tiles are stored once). Default = auto (tiles with the bitboard or active" << std :: endl;
+    std :: cout << "             engine and --cycle-detect history, compressed otherwise)." << std :: endl;
+    std :: cout << "    --fast-forward Once a cycle is found, jump straight to the last generation before --maxgen." << std :: endl;
+    std :: cout << "    --replay-cycle Once a cycle is found, keep going up to --maxgen, replaying the cycle." << std :: endl;
+    std :: cout << "    --batch Simulate every input file (.txt or .dat) as an independent job, printing only" << std :: endl;
+    std :: cout << "             one summary line per file: ending, last generation and period." << std :: endl;
+    std :: cout << "    --jobs <num> # of input files simulated at once with --batch, up to 1024. Default = one per core." << std :: endl;
     std :: cout << std :: endl;
     std :: cout << "Available colors are:" << std :: endl;
     std :: cout << "BLACK BLUE CRIMSON DARK_GREEN DEEP_SKY_BLUE DODGER_BLUE GREEN LIGHT_BLUE" << std :: endl;
     std :: cout << "LIGHT_GREY LIGHT_YELLOW RED STEEL_BLUE WHITE YELLOW" << std :: endl;
 };
 
+/*!
+ * Reads the whole number given to an option, within a range.
+ *
+ * Anything but digits (a sign included) is refused, so "-1" cannot wrap
+ * around to a huge count; an invalid value ends the program, as a missing
+ * one does, with the range expected.
+ * @param text Value given on the command line.
+ * @param min Smallest value accepted.
+ * @param max Largest value accepted.
+ * @param what Name of the value, for the error message.
+ * @return The value.
+ */
+unsigned long long read_count(const std :: string& text, unsigned long long min, unsigned long long max, const std :: string& what){
+    bool valid = !text.empty() && std :: all_of(text.begin(), text.end(), [](char c){ return std :: isdigit(static_cast<unsigned char>(c)) != 0; });
+    unsigned long long value = 0;
+    if (valid){
+        try {value = std :: stoull(text);}
+        catch (const std :: out_of_range&){valid = false;}
+    }
+    if (!valid || value < min || value > max){
+        std :: cout << "Invalid " << what << ": expected a whole number from " << min << " to " << max
+                    << ", got \"" << text << "\"." << std :: endl;
+        help_message();
+        exit(1);
+    }
+    return value;
+};
+
 RunningOpt validate_input(int argc, char* argv[]){
     RunningOpt input;
     input.pixel_size = 5;
@@ -64,7 +165,25 @@ RunningOpt validate_input(int argc, char* argv[]){
     input.fps = 0;
     input.image_dir = "";
     input.file_name = "";
+    input.batch = false;
+    input.jobs = 0;
     input.generations = 50;
+    input.threads = 1;
+    input.schedule = "bands";
+    input.engine = "bitboard";
+    input.kernel = "adder";
+    input.simd = "auto";
+    input.pin = false;
+    input.huge_pages = false;
+    input.shards = 1;
+    input.boundary = "torus";
+    input.rule = "B3/S23";
+    input.step = 1;
+    input.temporal = 1;
+    input.cycle_detect = "history";
+    input.on_cycle = "stop";
+    input.history_mem = 0;
+    input.history_store = "auto";
     if (argc == 1){
         help_message();
         exit(1);
@@ -85,7 +204,7 @@ RunningOpt validate_input(int argc, char* argv[]){
             exit(1);
         }
         else if(arg == "--maxgen"){
-            if (i + 1 < argc){input.generations = std :: stoi(argv[i + 1]);}
+            if (i + 1 < argc){input.generations = read_count(argv[i + 1], 0, ULLONG_MAX, "max of generations");}
             else {
                 std :: cout << "max of generations was not provided!" << std :: endl;
                 help_message();
@@ -93,7 +212,7 @@ RunningOpt validate_input(int argc, char* argv[]){
             }
         }
         else if(arg == "--fps"){
-            if (i + 1 < argc){input.fps = std :: stoi(argv[i + 1]);}
+            if (i + 1 < argc){input.fps = static_cast<unsigned>(read_count(argv[i + 1], 0, UINT_MAX, "fps"));}
             else {
                 std :: cout << "Fps was not provided!" << std :: endl;
                 help_message();
@@ -109,7 +228,7 @@ RunningOpt validate_input(int argc, char* argv[]){
             }
         }
         else if(arg == "--blocksize"){
-            if (i + 1 < argc){input.pixel_size = std :: stoi(argv[i + 1]);}
+            if (i + 1 < argc){input.pixel_size = read_count(argv[i + 1], 1, SHRT_MAX, "block size");}
             else {
                 std :: cout << "Block size was not provided!" << std :: endl;
                 help_message();
@@ -144,8 +263,129 @@ RunningOpt validate_input(int argc, char* argv[]){
                 exit(1);
             }
         }
-        else if (arg.size() > 4 && arg.substr(arg.size() - 4) == ".txt"){
+        else if (arg == "--threads"){
+            if (i + 1 < argc){input.threads = static_cast<unsigned>(read_count(argv[i + 1], 1, max_workers, "# of threads"));}
+            else {
+                std :: cout << "# of threads was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--schedule"){
+            if (i + 1 < argc){input.schedule = argv[i + 1];}
+            else {
+                std :: cout << "Schedule was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--engine"){
+            if (i + 1 < argc){input.engine = argv[i + 1];}
+            else {
+                std :: cout << "Engine was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--boundary"){
+            if (i + 1 < argc){input.boundary = argv[i + 1];}
+            else {
+                std :: cout << "Boundary was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--rule"){
+            if (i + 1 < argc){input.rule = argv[i + 1];}
+            else {
+                std :: cout << "Rule was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--simd"){
+            if (i + 1 < argc){input.simd = argv[i + 1];}
+            else {
+                std :: cout << "Instruction set was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--kernel"){
+            if (i + 1 < argc){input.kernel = argv[i + 1];}
+            else {
+                std :: cout << "Kernel was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--step"){
+            if (i + 1 < argc){input.step = read_count(argv[i + 1], 1, ULLONG_MAX, "generation step");}
+            else {
+                std :: cout << "Generation step was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--shards"){
+            if (i + 1 < argc){input.shards = static_cast<unsigned>(read_count(argv[i + 1], 1, max_workers, "# of shards"));}
+            else {
+                std :: cout << "# of shards was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--temporal"){
+            if (i + 1 < argc){input.temporal = static_cast<unsigned>(read_count(argv[i + 1], 1, UINT_MAX, "temporal blocking depth"));}
+            else {
+                std :: cout << "Temporal blocking depth was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--cycle-detect"){
+            if (i + 1 < argc){input.cycle_detect = argv[i + 1];}
+            else {
+                std :: cout << "Cycle detection was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg.rfind("--cycle-detect=", 0) == 0){
+            input.cycle_detect = arg.substr(arg.find('=') + 1);
+        }
+        else if (arg == "--history-mem"){
+            if (i + 1 < argc){input.history_mem = read_count(argv[i + 1], 0, SIZE_MAX >> 20, "history memory cap");}
+            else {
+                std :: cout << "History memory cap was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--history-store"){
+            if (i + 1 < argc){input.history_store = argv[i + 1];}
+            else {
+                std :: cout << "History store was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg == "--fast-forward"){input.on_cycle = "fast-forward";}
+        else if (arg == "--replay-cycle"){input.on_cycle = "replay";}
+        else if (arg == "--pin"){input.pin = true;}
+        else if (arg == "--hugepages"){input.huge_pages = true;}
+        else if (arg == "--batch"){input.batch = true;}
+        else if (arg == "--jobs"){
+            if (i + 1 < argc){input.jobs = static_cast<unsigned>(read_count(argv[i + 1], 1, max_workers, "# of jobs"));}
+            else {
+                std :: cout << "# of jobs was not provided!" << std :: endl;
+                help_message();
+                exit(1);
+            }
+        }
+        else if (arg.size() > 4 && (arg.substr(arg.size() - 4) == ".txt" || arg.substr(arg.size() - 4) == ".dat")){
             input.file_name = arg;
+            input.files.push_back(arg);
         }
     }
     if (input.file_name == ""){
@@ -153,15 +393,183 @@ RunningOpt validate_input(int argc, char* argv[]){
         help_message();
         exit(1);
     }
+    if (input.files.size() > 1 && !input.batch){
+        std :: cout << "Several input files were provided, but only one is simulated without --batch!" << std :: endl;
+        help_message();
+        exit(1);
+    }
+    if (input.engine == "sliced" && !input.batch){
+        std :: cout << "The sliced engine simulates up to 64 input files at once, it needs --batch!" << std :: endl;
+        exit(1);
+    }
+    if (input.batch && input.shards > 1){
+        std :: cout << "The jobs of --batch run as threads, they cannot fork shards!" << std :: endl;
+        exit(1);
+    }
+    if (input.batch && input.pin){
+        std :: cout << "The jobs of --batch would pin their threads to the same CPUs!" << std :: endl;
+        exit(1);
+    }
+    if (input.batch && input.image_dir != ""){
+        std :: cout << "The jobs of --batch would overwrite each other's images in --imgdir!" << std :: endl;
+        exit(1);
+    }
     return input;
 };
 
+/*!
+ * Sets a life configuration up with the options provided by the user.
+ * @param cw Configuration to set up.
+ * @param input Options provided by the user.
+ * @param file Input file of the configuration.
+ */
+void configure(life :: LifeCfg& cw, const RunningOpt& input, const std :: string& file){
+    cw.start(input.generations, file, input.image_dir, input.cell_color, input.back_color, input.pixel_size, input.fps, input.threads);
+    cw.set_schedule(input.schedule);
+    cw.set_engine(input.engine);
+    cw.set_boundary(input.boundary);
+    cw.set_kernel(input.kernel);
+    cw.set_simd(input.simd);
+    cw.set_pin(input.pin);
+    cw.set_huge_pages(input.huge_pages);
+    cw.set_shards(input.shards);
+    cw.set_rule(input.rule);
+    cw.set_gen_step(input.step);
+    cw.set_temporal(input.temporal);
+    cw.set_cycle_detect(input.cycle_detect);
+    cw.set_on_cycle(input.on_cycle);
+    cw.set_history_mem(input.history_mem);
+    cw.set_history_store(input.history_store);
+};
+
+/*!
+ * Checks that a file opens and has a header the simulation accepts.
+ * @param file Input file.
+ * @param rows Receives the # of rows stated.
+ * @param cols Receives the # of columns stated.
+ * @param error Receives the reason, if the file can not be simulated.
+ * @return True if the file can be simulated.
+ */
+bool readable(const std :: string& file, size_t& rows, size_t& cols, std :: string& error){
+    std :: ifstream in(file);
+    if (!in.is_open()){
+        error = "Unable to open the file!";
+        return false;
+    }
+    char alive;
+    try {life :: LifeCfg :: read_header(in, rows, cols, alive);}
+    catch (const std :: runtime_error& e){
+        error = e.what();
+        return false;
+    }
+    return true;
+};
+
+/*!
+ * Simulates every input file as an independent job and prints one line per file.
+ *
+ * The configurations are set up (and their options validated) on this thread.
+ * The first one is also started here, so that an option that does not fit the
+ * others is reported once, before the jobs run. Every job then owns its
+ * configuration, and the workers share nothing but the index of the next job.
+ * Files that can not be simulated, found either by read_header() up front or
+ * by read_file() throwing as a job starts, are reported as "unreadable" (and
+ * the reason on the error output) instead of ending the whole batch. With the sliced engine, a job is a pack of up to
+ * 64 files of the same size, run together (see LifeCfg::run_sliced()).
+ * @param input Options provided by the user.
+ */
+void run_batch(const RunningOpt& input){
+    std :: vector<std :: unique_ptr<life :: LifeCfg>> jobs(input.files.size());
+    std :: vector<std :: string> summary(input.files.size());
+    life :: LifeCfg* first = nullptr;
+    std :: vector<std :: string> errors(input.files.size());
+    auto unreadable = [&](size_t job, const std :: string& error){
+        summary[job] = input.files[job] + "\tunreadable\t0\t0";
+        errors[job] = error;
+        jobs[job].reset();
+    };
+    std :: vector<std :: pair<size_t, size_t>> sizes(jobs.size());
+    for (size_t job = 0; job < jobs.size(); job++){
+        std :: string error;
+        if (!readable(input.files[job], sizes[job].first, sizes[job].second, error)){
+            unreadable(job, error);
+            continue;
+        }
+        jobs[job].reset(new life :: LifeCfg());
+        configure(*jobs[job], input, input.files[job]);
+        jobs[job]->set_quiet(true);
+    }
+    for (size_t job = 0; job < jobs.size() && first == nullptr; job++){
+        if (!jobs[job]){continue;}
+        try {
+            jobs[job]->update();
+            first = jobs[job].get();
+        }
+        catch (const std :: runtime_error& e){unreadable(job, e.what());}
+    }
+    // Each pack lists the files simulated by one job.
+    std :: vector<std :: vector<size_t>> packs;
+    const size_t pack_size = (input.engine == "sliced") ? life :: SlicedBoards :: lanes : 1;
+    std :: map<std :: pair<size_t, size_t>, size_t> open_pack;
+    for (size_t job = 0; job < jobs.size(); job++){
+        if (!jobs[job]){continue;}
+        auto it = open_pack.find(sizes[job]);
+        if (it == open_pack.end() || packs[it->second].size() == pack_size){
+            it = open_pack.insert_or_assign(sizes[job], packs.size()).first;
+            packs.emplace_back();
+        }
+        packs[it->second].push_back(job);
+    }
+    unsigned int workers = input.jobs;
+    if (workers == 0){workers = std :: max(1u, std :: thread :: hardware_concurrency());}
+    workers = static_cast<unsigned int>(std :: max<size_t>(1, std :: min<size_t>(workers, packs.size())));
+    std :: atomic<size_t> next(0);
+    life :: ThreadPool pool(workers);
+    pool.run([&](size_t){
+        for (size_t p = next++; p < packs.size(); p = next++){
+            std :: vector<life :: LifeCfg*> pack;
+            for (size_t job : packs[p]){pack.push_back(jobs[job].get());}
+            try {
+                if (input.engine == "sliced"){life :: LifeCfg :: run_sliced(pack);}
+                for (size_t job : packs[p]){
+                    life :: LifeCfg& cw = *jobs[job];
+                    while (not cw.exit_conway()){cw.update();}
+                    summary[job] = input.files[job] + "\t" + cw.ending() + "\t" + std :: to_string(cw.generation()) + "\t" + std :: to_string(cw.period());
+                    // The tables and the history of a finished job are not needed for the summary.
+                    jobs[job].reset();
+                }
+            }
+            catch (const std :: runtime_error& e){
+                // Every file of the pack still unfinished goes down with the one that could not be read.
+                for (size_t job : packs[p]){
+                    if (jobs[job]){unreadable(job, e.what());}
+                }
+            }
+        }
+    });
+    std :: cout << "file\tending\tgenerations\tperiod" << std :: endl;
+    for (const std :: string& line : summary){std :: cout << line << std :: endl;}
+    for (size_t job = 0; job < errors.size(); job++){
+        if (!errors[job].empty()){std :: cerr << input.files[job] << ": " << errors[job] << std :: endl;}
+    }
+};
+
 int main(int argc, char* argv[]) { 
-    life :: LifeCfg cw;
     RunningOpt input = validate_input(argc, argv);
-    cw.start(input.generations, input.file_name, input.image_dir, input.cell_color, input.back_color, input.pixel_size, input.fps);
-    while(not cw.exit_conway()){
-        cw.update();
+    if (input.batch){
+        run_batch(input);
+        return EXIT_SUCCESS;
+    }
+    life :: LifeCfg cw;
+    configure(cw, input, input.file_name);
+    try {
+        while(not cw.exit_conway()){
+            cw.update();
+        }
+    }
+    catch (const std :: runtime_error& e){
+        std :: cerr << e.what() << std :: endl;
+        return EXIT_FAILURE;
     }
     return EXIT_SUCCESS; 
 }
@@ -0,0 +1,56 @@
+/**
+ * Rule implementation.
+ *
+ */
+
+#include "rule.h"
+#include <cctype>
+
+namespace life {
+
+/**
+ * @brief Reads a rule in B/S notation.
+ * @param text The rule, as "B" digits "/" "S" digits (e.g. "B36/S23").
+ * @param rule Receives the rule, if well formed.
+ * @return True if text is a well formed rule.
+ */
+bool Rule :: parse(const std :: string& text, Rule& rule){
+    Rule read{0, 0};
+    uint16_t* digits = nullptr;
+    bool seen_b = false, seen_s = false;
+    for (char c : text){
+        char u = static_cast<char>(std :: toupper(static_cast<unsigned char>(c)));
+        if (u == 'B' && !seen_b && !seen_s){
+            digits = &read.birth;
+            seen_b = true;
+        }
+        else if (u == 'S' && seen_b && !seen_s){
+            digits = &read.survive;
+            seen_s = true;
+        }
+        else if (u == '/' && seen_b && !seen_s){digits = nullptr;}
+        else if (u >= '0' && u <= '8' && digits != nullptr){*digits |= static_cast<uint16_t>(1 << (u - '0'));}
+        else {return false;}
+    }
+    if (!seen_b || !seen_s){return false;}
+    rule = read;
+    return true;
+};
+
+/**
+ * @brief Writes the rule in B/S notation.
+ * @return The rule, e.g. "B36/S23".
+ */
+std :: string Rule :: name(void) const{
+    std :: string text = "B";
+    for (int n = 0; n <= 8; n++){
+        if ((birth >> n) & 1){text += static_cast<char>('0' + n);}
+    }
+    text += "/S";
+    for (int n = 0; n <= 8; n++){
+        if ((survive >> n) & 1){text += static_cast<char>('0' + n);}
+    }
+    return text;
+};
+
+}  // namespace life
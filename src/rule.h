@@ -0,0 +1,63 @@
+//! Life-like rules, in B/S notation.
+/*!
+ * @file rule.h
+ *
+ * @details Struct Rule, the birth and survival conditions of a Life-like
+ * automaton, and the rules known at compile time.
+ */
+
+#ifndef _RULE_H_
+#define _RULE_H_
+
+#include <cstdint>
+#include <string>
+
+namespace life {
+
+/// The birth and survival conditions of a Life-like automaton.
+/*!
+ * Bit n of `birth` is set if a dead cell with n alive neighbors becomes
+ * alive, bit n of `survive` if an alive cell with n alive neighbors stays
+ * alive. The default is Conway's rule, B3/S23.
+ */
+struct Rule {
+    uint16_t birth = 1 << 3;                    //!< Neighbor counts that give birth.
+    uint16_t survive = (1 << 2) | (1 << 3);     //!< Neighbor counts that keep a cell alive.
+
+    //!< Returns the next state of a cell.
+    constexpr bool next(bool alive, unsigned n_alives) const {
+        return ((alive ? survive : birth) >> n_alives) & 1;
+    }
+
+    bool operator==(const Rule& rhs) const { return birth == rhs.birth && survive == rhs.survive; }
+    bool operator!=(const Rule& rhs) const { return !(*this == rhs); }
+
+    //!< Reads a rule such as "B36/S23" (case-insensitive); returns false if malformed.
+    static bool parse(const std::string& text, Rule& rule);
+
+    //!< Returns the rule in B/S notation.
+    std::string name(void) const;
+};
+
+/// A rule fixed at compile time, so kernels specialized on it fold it away.
+template <uint16_t B, uint16_t S>
+struct StaticRule {
+    static constexpr uint16_t birth(const Rule&) { return B; }
+    static constexpr uint16_t survive(const Rule&) { return S; }
+};
+
+/// Any rule, read at run time: the generic fallback of the specialized kernels.
+struct AnyRule {
+    static uint16_t birth(const Rule& rule) { return rule.birth; }
+    static uint16_t survive(const Rule& rule) { return rule.survive; }
+};
+
+typedef StaticRule<0x008, 0x00c> Conway;            //!< B3/S23.
+typedef StaticRule<0x048, 0x00c> HighLife;          //!< B36/S23.
+typedef StaticRule<0x1c8, 0x1d8> DayAndNight;       //!< B3678/S34678.
+typedef StaticRule<0x004, 0x000> Seeds;             //!< B2/S.
+typedef StaticRule<0x008, 0x1ff> LifeWithoutDeath;  //!< B3/S012345678.
+
+}  // namespace life
+
+#endif
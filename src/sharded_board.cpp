@@ -0,0 +1,408 @@
+/**
+ * ShardedBoard class implementation.
+ *
+ */
+
+#include "sharded_board.h"
+#include "bitboard.h"
+#include "thread_pool.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <thread>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+namespace life {
+
+/**
+ * @brief Sends a whole message on a socket.
+ * @param socket Socket.
+ * @param data Message.
+ * @param bytes Size of the message.
+ * @return False if the other end is gone.
+ */
+static bool send_all(int socket, const void* data, size_t bytes){
+    const char* from = static_cast<const char*>(data);
+    while (bytes > 0){
+#ifdef MSG_NOSIGNAL
+        const ssize_t sent = ::send(socket, from, bytes, MSG_NOSIGNAL);
+#else
+        const ssize_t sent = ::send(socket, from, bytes, 0);
+#endif
+        if (sent < 0 && errno == EINTR){continue;}
+        if (sent <= 0){return false;}
+        from += sent;
+        bytes -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+/**
+ * @brief Receives a whole message from a socket.
+ * @param socket Socket.
+ * @param data Receives the message.
+ * @param bytes Size of the message.
+ * @return False if the other end is gone.
+ */
+static bool receive_all(int socket, void* data, size_t bytes){
+    char* to = static_cast<char*>(data);
+    while (bytes > 0){
+        const ssize_t got = ::recv(socket, to, bytes, 0);
+        if (got < 0 && errno == EINTR){continue;}
+        if (got <= 0){return false;}
+        to += got;
+        bytes -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+/**
+ * @brief Constructor for ShardedBoard class. Every cell starts dead.
+ *
+ * The shared segment is mapped here; the workers are only forked at the
+ * first step (or query), once the cells are set.
+ * @param rows # of rows.
+ * @param cols # of columns.
+ * @param shards # of worker processes, 1 to rows.
+ * @param boundary How the edges are glued together (any but the cross-surface).
+ * @param threads # of threads that step the shard of each worker.
+ */
+ShardedBoard :: ShardedBoard(size_t rows, size_t cols, size_t shards, boundary_e boundary, unsigned threads) :
+    m_rows(rows),
+    m_cols(cols),
+    m_words((cols + word_bits - 1) / word_bits),
+    m_shards(std :: max<size_t>(1, std :: min(shards, rows))),
+    m_threads(threads),
+    m_boundary(boundary),
+    m_rule(),
+    m_shared(nullptr),
+    m_shared_bytes(0),
+    m_published(nullptr),
+    m_cells(nullptr),
+    m_halos(nullptr),
+    m_pids(),
+    m_sockets(),
+    m_synced(true),
+    m_loaded(false),
+    m_population(0),
+    m_hash(0)
+    {
+        const size_t counters = m_shards * sizeof(Counter);
+        const size_t cells = m_rows * m_words * sizeof(word_t);
+        const size_t halos = m_shards * 4 * m_words * sizeof(word_t);
+        m_shared_bytes = counters + cells + halos;
+        m_shared = mmap(nullptr, m_shared_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (m_shared == MAP_FAILED){
+            std :: cerr << "The shared memory of the shards could not be mapped!" << std :: endl;
+            std :: exit(EXIT_FAILURE);
+        }
+        // The mapping starts zeroed, and page aligned.
+        m_published = static_cast<Counter*>(m_shared);
+        for (size_t s = 0; s < m_shards; s++){new (&m_published[s]) Counter{{0}};}
+        m_cells = reinterpret_cast<word_t*>(static_cast<char*>(m_shared) + counters);
+        m_halos = m_cells + m_rows * m_words;
+    }
+
+/**
+ * @brief Destructor for ShardedBoard class. Stops and reaps every worker.
+ */
+ShardedBoard :: ~ShardedBoard(){
+    const Command quit{static_cast<uint32_t>(op_e :: QUIT), 0, 0, 0};
+    for (size_t s = 0; s < m_sockets.size(); s++){
+        send_all(m_sockets[s], &quit, sizeof(quit));
+        close(m_sockets[s]);
+        waitpid(m_pids[s], nullptr, 0);
+    }
+    munmap(m_shared, m_shared_bytes);
+};
+
+/**
+ * @brief Returns an edge row of a shard, in the shared segment.
+ * @param shard Shard.
+ * @param gen Generation of the row; consecutive generations use different slots.
+ * @param edge 0 for the first row of the shard, 1 for the last one.
+ * @return m_words words.
+ */
+ShardedBoard :: word_t* ShardedBoard :: halo(size_t shard, unsigned long long gen, unsigned edge) const{
+    return m_halos + ((shard * 2 + gen % 2) * 2 + edge) * m_words;
+};
+
+/**
+ * @brief Forks one worker per shard, each connected by a socket of its own.
+ */
+void ShardedBoard :: start(void) const{
+    for (size_t s = 0; s < m_shards; s++){
+        int ends[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) != 0){
+            std :: cerr << "The sockets of the shards could not be created!" << std :: endl;
+            std :: exit(EXIT_FAILURE);
+        }
+        const pid_t pid = fork();
+        if (pid < 0){
+            std :: cerr << "The process of shard " << s << " could not be started!" << std :: endl;
+            std :: exit(EXIT_FAILURE);
+        }
+        if (pid == 0){
+            close(ends[0]);
+            for (int socket : m_sockets){close(socket);}
+            serve(s, ends[1]);
+            _exit(EXIT_SUCCESS);
+        }
+        close(ends[1]);
+        m_pids.push_back(pid);
+        m_sockets.push_back(ends[0]);
+    }
+};
+
+/**
+ * @brief Sends a command to every worker, and sums up their replies.
+ *
+ * A worker that does not reply is gone: every worker is killed, since the
+ * others would wait for its edge rows forever, and the simulation ends.
+ * @param order Command.
+ */
+void ShardedBoard :: command(const Command& order) const{
+    std :: atomic_thread_fence(std :: memory_order_release);
+    size_t lost = m_shards;
+    for (size_t s = 0; s < m_shards && lost == m_shards; s++){
+        if (!send_all(m_sockets[s], &order, sizeof(order))){lost = s;}
+    }
+    m_population = 0;
+    m_hash = 0;
+    for (size_t s = 0; s < m_shards && lost == m_shards; s++){
+        Reply reply;
+        if (!receive_all(m_sockets[s], &reply, sizeof(reply))){
+            lost = s;
+            break;
+        }
+        m_population += reply.population;
+        m_hash ^= reply.hash;
+    }
+    if (lost != m_shards){
+        for (pid_t pid : m_pids){kill(pid, SIGKILL);}
+        std :: cerr << "The process of shard " << lost << " stopped responding!" << std :: endl;
+        std :: exit(EXIT_FAILURE);
+    }
+    std :: atomic_thread_fence(std :: memory_order_acquire);
+};
+
+/**
+ * @brief Makes the workers hold the cells of the shared board, forking them if needed.
+ */
+void ShardedBoard :: load(void) const{
+    if (m_pids.empty()){start();}
+    command(Command{static_cast<uint32_t>(op_e :: LOAD), 0, 0, 0});
+    m_loaded = true;
+};
+
+/**
+ * @brief Makes the shared board hold the current generation.
+ */
+void ShardedBoard :: sync(void) const{
+    if (m_synced){return;}
+    command(Command{static_cast<uint32_t>(op_e :: SYNC), 0, 0, 0});
+    m_synced = true;
+};
+
+/**
+ * @brief Runs a worker: steps its shard as the coordinator commands.
+ *
+ * Rows 1 to height of the BitBoard of the worker are its shard, and rows
+ * 0 and height + 1 the edge rows of its neighbors. The columns wrap around
+ * (unmirrored, on a Klein bottle too) or are dead in that BitBoard as on
+ * the whole board, so only the rows come from the neighbors.
+ * @param shard Shard of the worker.
+ * @param socket Socket to the coordinator.
+ */
+void ShardedBoard :: serve(size_t shard, int socket) const{
+#ifdef __linux__
+    // A worker outliving the coordinator would wait forever.
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+    const size_t first = shard * m_rows / m_shards;
+    const size_t height = (shard + 1) * m_rows / m_shards - first;
+    std :: unique_ptr<ThreadPool> pool((m_threads > 1) ? new ThreadPool(m_threads) : nullptr);
+    BitBoard band;
+    band.pool(pool.get());
+    band.resize(height + 2, m_cols);
+    band.boundary(m_boundary == boundary_e :: DEAD ? boundary_e :: DEAD : boundary_e :: TORUS);
+    band.rule(m_rule);
+    const std :: vector<word_t> dead(m_words, 0);
+    unsigned long long gen = 0;
+    Command order;
+    while (receive_all(socket, &order, sizeof(order))){
+        std :: atomic_thread_fence(std :: memory_order_acquire);
+        const op_e op = static_cast<op_e>(order.op);
+        if (op == op_e :: QUIT){return;}
+        else if (op == op_e :: LOAD){
+            for (size_t i = 0; i < height; i++){band.set_row(i + 1, m_cells + (first + i) * m_words);}
+        }
+        else if (op == op_e :: SYNC){
+            for (size_t i = 0; i < height; i++){std :: copy(band.row(i + 1), band.row(i + 1) + m_words, m_cells + (first + i) * m_words);}
+        }
+        else if (op == op_e :: RULE){
+            Rule rule;
+            rule.birth = order.birth;
+            rule.survive = order.survive;
+            band.rule(rule);
+        }
+        else if (op == op_e :: STEP){
+            for (unsigned long long i = 0; i < order.count; i++, gen++){
+                exchange(shard, band, gen, dead.data());
+                band.step(1);
+            }
+        }
+        // Keys of the rows of the whole board, so the shards add up to its fingerprint.
+        Reply reply{0, 0};
+        for (size_t i = 0; i < height; i++){
+            const word_t* x = band.row(i + 1);
+            for (size_t w = 0; w < m_words; w++){
+                reply.population += static_cast<unsigned long long>(__builtin_popcountll(x[w]));
+                reply.hash ^= word_key((first + i) * m_words + w, x[w]);
+            }
+        }
+        std :: atomic_thread_fence(std :: memory_order_release);
+        if (!send_all(socket, &reply, sizeof(reply))){return;}
+    }
+};
+
+/**
+ * @brief Swaps edge rows with the neighbors of a shard, for one generation.
+ *
+ * The edge rows of the shard are published in the slot of the generation,
+ * and those of its neighbors are copied into its halo once they are
+ * published too. A neighbor cannot publish two generations later (and
+ * overwrite the slot) before this shard has published the next one, so
+ * two slots suffice. On a dead board the first and last shards have no
+ * neighbor past the edge; on a Klein bottle, the rows across it come
+ * mirrored.
+ * @param shard Shard.
+ * @param band Cells of the shard, with the halo rows.
+ * @param gen Generation of the cells.
+ * @param dead A row of dead cells.
+ */
+void ShardedBoard :: exchange(size_t shard, BitBoard& band, unsigned long long gen, const word_t* dead) const{
+    const size_t height = band.rows() - 2;
+    std :: copy(band.row(1), band.row(1) + m_words, halo(shard, gen, 0));
+    std :: copy(band.row(height), band.row(height) + m_words, halo(shard, gen, 1));
+    m_published[shard].gen.store(gen + 1, std :: memory_order_release);
+    const size_t last = m_shards - 1;
+    const bool wraps = m_boundary != boundary_e :: DEAD;
+    const bool has_up = shard > 0 || wraps;
+    const bool has_down = shard < last || wraps;
+    const size_t up = (shard > 0) ? shard - 1 : last;
+    const size_t down = (shard < last) ? shard + 1 : 0;
+    while ((has_up && m_published[up].gen.load(std :: memory_order_acquire) <= gen) ||
+           (has_down && m_published[down].gen.load(std :: memory_order_acquire) <= gen)){
+        std :: this_thread :: yield();
+    }
+    // Halo rows are stepped with the shard, so even dead ones are reset.
+    const bool mirrored = m_boundary == boundary_e :: KLEIN;
+    band.set_row(0, has_up ? halo(up, gen, 1) : dead, mirrored && shard == 0);
+    band.set_row(height + 1, has_down ? halo(down, gen, 0) : dead, mirrored && shard == last);
+};
+
+/**
+ * @brief Returns the state of a cell, from the shared board.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @return True if the cell is alive.
+ */
+bool ShardedBoard :: get(size_t row, size_t col) const{
+    sync();
+    return (m_cells[row * m_words + col / word_bits] >> (col % word_bits)) & 1;
+};
+
+/**
+ * @brief Sets the state of a cell, on the shared board; the workers read it before the next step.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @param alive New state of the cell.
+ */
+void ShardedBoard :: set(size_t row, size_t col, bool alive){
+    sync();
+    word_t& word = m_cells[row * m_words + col / word_bits];
+    const word_t bit = word_t(1) << (col % word_bits);
+    if (static_cast<bool>(word & bit) == alive){return;}
+    word ^= bit;
+    m_loaded = false;
+};
+
+/**
+ * @brief Returns the # of alive cells, summed up by the workers.
+ * @return # of alive cells.
+ */
+unsigned long long ShardedBoard :: population(void) const{
+    if (!m_loaded){load();}
+    return m_population;
+};
+
+/**
+ * @brief Advances every shard by several generations, in a single command.
+ * @param generations # of generations.
+ */
+void ShardedBoard :: step(unsigned long long generations){
+    if (generations == 0){return;}
+    if (!m_loaded){load();}
+    command(Command{static_cast<uint32_t>(op_e :: STEP), 0, 0, generations});
+    m_synced = false;
+};
+
+/**
+ * @brief Sets the birth and survival conditions of every shard.
+ * @param rule Rule.
+ */
+void ShardedBoard :: rule(const Rule& rule){
+    m_rule = rule;
+    if (!m_pids.empty()){command(Command{static_cast<uint32_t>(op_e :: RULE), rule.birth, rule.survive, 0});}
+};
+
+/**
+ * @brief Copies a square block of cells from the shared board.
+ * @param tile_row Row of the block, in blocks.
+ * @param tile_col Column of the block, in blocks.
+ * @param side Side of the block, a multiple of 64.
+ * @param out Receives side rows of side / 64 words; cells past the board are dead.
+ */
+void ShardedBoard :: read_tile(size_t tile_row, size_t tile_col, size_t side, uint64_t* out) const{
+    sync();
+    const size_t words = side / word_bits;
+    const size_t r0 = tile_row * side;
+    const size_t w0 = tile_col * words;
+    for (size_t i = 0; i < side; i++){
+        for (size_t w = 0; w < words; w++){
+            out[i * words + w] = (r0 + i < m_rows && w0 + w < m_words) ? m_cells[(r0 + i) * m_words + w0 + w] : 0;
+        }
+    }
+};
+
+/**
+ * @brief Returns the fingerprint of the board, the XOR of those of the shards.
+ * @return The fingerprint a BitBoard with the same cells would have.
+ */
+uint64_t ShardedBoard :: fingerprint(void){
+    if (!m_loaded){load();}
+    return m_hash;
+};
+
+/**
+ * @brief Copies the cells of the board, row after row, without padding.
+ * @param out Receives rows() * ceil(cols() / 64) words.
+ */
+void ShardedBoard :: snapshot(std :: vector<uint64_t>& out){
+    sync();
+    out.assign(m_cells, m_cells + m_rows * m_words);
+};
+
+}  // namespace life
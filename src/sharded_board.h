@@ -0,0 +1,146 @@
+//! This class implements a board split across worker processes.
+/*!
+ * @file sharded_board.h
+ *
+ * @details Class ShardedBoard, a bounded board cut into horizontal shards,
+ * each one stepped by a process of its own. Neighboring shards swap their
+ * edge rows every generation through shared memory.
+ */
+
+#ifndef _SHARDED_BOARD_H_
+#define _SHARDED_BOARD_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <sys/types.h>
+#include "boundary.h"
+#include "engine.h"
+#include "rule.h"
+
+namespace life {
+
+class BitBoard;
+
+/// A bounded board whose rows are shared out among local worker processes.
+/*!
+ * Shard s holds rows [s * rows / shards, (s + 1) * rows / shards) in a
+ * BitBoard of its own, with one extra row above and below for the edge
+ * rows of its neighbors (the halo). The workers are forked at the first
+ * step, and wait for commands on a UNIX socket; this object, in the
+ * calling process, is the coordinator.
+ *
+ * To step, every worker publishes its first and last rows in a POSIX
+ * shared-memory segment, one slot per generation parity, and copies the
+ * edge rows of its neighbors into its halo once they have published the
+ * same generation. Workers only wait for their neighbors, never for the
+ * coordinator, so a command steps any # of generations. Each reply carries
+ * the population and the fingerprint of the shard, from which the
+ * coordinator answers population() and fingerprint() (the same fingerprint
+ * as a BitBoard of the whole board), so cycles, extinction and maxgen are
+ * decided without gathering the cells. The cells are only copied to the
+ * shared segment when they are read.
+ *
+ * Nothing but the command protocol ties a worker to this host: the shared
+ * segment could become messages between hosts. A worker that dies ends the
+ * simulation with an error.
+ */
+class ShardedBoard : public Engine {
+    public:
+    typedef uint64_t word_t;                    //!< Storage word, 64 cells.
+    static constexpr size_t word_bits = 64;     //!< # of cells per word.
+
+    private:
+    /// Generations published by a worker, alone on its cache line.
+    struct alignas(64) Counter {
+        std::atomic<unsigned long long> gen;    //!< # of generations whose edge rows are published.
+    };
+    static_assert(std::atomic<unsigned long long>::is_always_lock_free, "counters are shared across processes");
+
+    /// Command sent to a worker.
+    struct Command {
+        uint32_t op;                //!< What to do (see ShardedBoard::op_e).
+        uint16_t birth;             //!< Birth conditions, for op_e::RULE.
+        uint16_t survive;           //!< Survival conditions, for op_e::RULE.
+        unsigned long long count;   //!< # of generations, for op_e::STEP.
+    };
+
+    /// Reply of a worker, once the command is done.
+    struct Reply {
+        unsigned long long population;  //!< # of alive cells of the shard.
+        uint64_t hash;                  //!< Fingerprint of the shard.
+    };
+
+    /// Commands of the workers.
+    enum class op_e : uint32_t {
+        LOAD = 0,       //!< Read the cells of the shard from the shared board.
+        SYNC,           //!< Write the cells of the shard to the shared board.
+        STEP,           //!< Advance a # of generations.
+        RULE,           //!< Set the birth and survival conditions.
+        QUIT,           //!< Exit.
+    };
+
+    size_t m_rows;                  //!< # of rows.
+    size_t m_cols;                  //!< # of columns.
+    size_t m_words;                 //!< # of words per row.
+    size_t m_shards;                //!< # of worker processes.
+    unsigned m_threads;             //!< # of threads of each worker.
+    boundary_e m_boundary;          //!< How the edges are glued together.
+    Rule m_rule;                    //!< Birth and survival conditions.
+    void* m_shared;                 //!< Segment shared with the workers.
+    size_t m_shared_bytes;          //!< Size of the segment.
+    Counter* m_published;           //!< Generations published by each worker, in the segment.
+    word_t* m_cells;                //!< Whole board, rows * m_words words, in the segment.
+    word_t* m_halos;                //!< Edge rows of each worker, per generation parity, in the segment.
+    // The workers are started, and they and the shared board brought up to
+    // date, lazily, from const getters too.
+    mutable std::vector<pid_t> m_pids;  //!< Worker processes.
+    mutable std::vector<int> m_sockets; //!< Command sockets of the workers.
+    mutable bool m_synced;          //!< Flag telling that m_cells holds the current generation.
+    mutable bool m_loaded;          //!< Flag telling that the workers hold the cells of m_cells.
+    mutable unsigned long long m_population;    //!< # of alive cells, from the last replies.
+    mutable uint64_t m_hash;        //!< Fingerprint, from the last replies.
+
+    //!< Returns edge row `edge` (0: first, 1: last) of a shard, for a generation.
+    word_t* halo(size_t shard, unsigned long long gen, unsigned edge) const;
+
+    //!< Forks the workers.
+    void start(void) const;
+
+    //!< Sends a command to every worker and gathers their replies.
+    void command(const Command& order) const;
+
+    //!< Makes the workers hold the cells of the shared board.
+    void load(void) const;
+
+    //!< Makes the shared board hold the current generation.
+    void sync(void) const;
+
+    //!< Body of a worker process.
+    void serve(size_t shard, int socket) const;
+
+    //!< Copies the edge rows of the neighbors of a shard into its halo, for a generation.
+    void exchange(size_t shard, BitBoard& band, unsigned long long gen, const word_t* dead) const;
+
+    public:
+    ShardedBoard(size_t rows, size_t cols, size_t shards, boundary_e boundary = boundary_e :: TORUS, unsigned threads = 1);
+    ~ShardedBoard();
+    ShardedBoard(const ShardedBoard&) = delete;
+    ShardedBoard& operator=(const ShardedBoard&) = delete;
+
+    size_t rows(void) const override { return m_rows; }
+    size_t cols(void) const override { return m_cols; }
+    bool get(size_t row, size_t col) const override;
+    void set(size_t row, size_t col, bool alive) override;
+    unsigned long long population(void) const override;
+    void step(unsigned long long generations) override;
+    void rule(const Rule& rule) override;
+    void read_tile(size_t tile_row, size_t tile_col, size_t side, uint64_t* out) const override;
+    uint64_t fingerprint(void) override;
+    void snapshot(std::vector<uint64_t>& out) override;
+};
+
+}  // namespace life
+
+#endif
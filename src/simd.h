@@ -0,0 +1,149 @@
+//! Vector versions of the adder kernel, picked at run time.
+/*!
+ * @file simd.h
+ *
+ * @details The adder kernel (see adder.h) over a run of words of a row,
+ * compiled for several widths of vector registers. The widest one the CPU
+ * supports is found once, with CPUID, so a single binary uses AVX-512 or
+ * AVX2 where they exist and SSE2 or plain 64-bit words elsewhere.
+ */
+
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "adder.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIFE_SIMD_X86 1
+#endif
+
+namespace life {
+
+/// Instruction sets the adder kernel is compiled for.
+enum class simd_e : short {
+    SCALAR = 0,     //!< One 64-bit word at a time.
+    SSE2,           //!< 2 words per 128-bit register.
+    AVX2,           //!< 4 words per 256-bit register.
+    AVX512,         //!< 8 words per 512-bit register.
+};
+
+/// Computes words [begin, end) of a row of the next generation.
+/*!
+ * The words at begin - 1 and end of the three rows are read, so the run
+ * must not include the last word of a row, whose east neighbor is not the
+ * next word (see BitBoard::step_span_adder()).
+ */
+typedef void (*adder_run_t)(const uint64_t* above, const uint64_t* mid, const uint64_t* below, uint64_t* out,
+                            size_t begin, size_t end, uint16_t birth, uint16_t survive);
+
+/// Loads the L words of a row at y, and the same words shifted one cell west and east.
+/*!
+ * The words are loaded unaligned, and so are the words just before and
+ * after them, to shift in the neighbors across word boundaries.
+ */
+template <class V>
+inline __attribute__((always_inline)) void load_row(const uint64_t* y, V& west, V& here, V& east){
+    V before, after;
+    std::memcpy(&here, y, sizeof(V));
+    std::memcpy(&before, y - 1, sizeof(V));
+    std::memcpy(&after, y + 1, sizeof(V));
+    west = (here << 1) | (before >> 63);
+    east = (here >> 1) | (after << 63);
+}
+
+/// The adder kernel over a run of words, L words per step in a V.
+/*!
+ * The words left over at the end of the run are done one at a time.
+ */
+template <class R, class V, size_t L>
+inline __attribute__((always_inline)) void adder_run(const uint64_t* above, const uint64_t* mid, const uint64_t* below,
+                                                     uint64_t* out, size_t begin, size_t end, uint16_t birth, uint16_t survive){
+    size_t w = begin;
+    if (L > 1){
+        for (; w + L <= end; w += L){
+            V west[3], here[3], east[3];
+            load_row(above + w, west[0], here[0], east[0]);
+            load_row(mid + w, west[1], here[1], east[1]);
+            load_row(below + w, west[2], here[2], east[2]);
+            const V next = adder_word<R>(birth, survive, west, here, east);
+            std::memcpy(out + w, &next, sizeof(V));
+        }
+    }
+    for (; w < end; w++){
+        uint64_t west[3], here[3], east[3];
+        load_row(above + w, west[0], here[0], east[0]);
+        load_row(mid + w, west[1], here[1], east[1]);
+        load_row(below + w, west[2], here[2], east[2]);
+        out[w] = adder_word<R>(birth, survive, west, here, east);
+    }
+}
+
+/// The adder kernel, one 64-bit word at a time.
+template <class R>
+void adder_run_scalar(const uint64_t* above, const uint64_t* mid, const uint64_t* below, uint64_t* out,
+                      size_t begin, size_t end, uint16_t birth, uint16_t survive){
+    adder_run<R, uint64_t, 1>(above, mid, below, out, begin, end, birth, survive);
+}
+
+#ifdef LIFE_SIMD_X86
+typedef uint64_t words2_t __attribute__((vector_size(16)));    //!< 2 words, in an SSE register.
+typedef uint64_t words4_t __attribute__((vector_size(32)));    //!< 4 words, in an AVX register.
+typedef uint64_t words8_t __attribute__((vector_size(64)));    //!< 8 words, in an AVX-512 register.
+
+/// The adder kernel, 2 words at a time (SSE2, always there on x86-64).
+template <class R>
+__attribute__((target("sse2")))
+void adder_run_sse2(const uint64_t* above, const uint64_t* mid, const uint64_t* below, uint64_t* out,
+                    size_t begin, size_t end, uint16_t birth, uint16_t survive){
+    adder_run<R, words2_t, 2>(above, mid, below, out, begin, end, birth, survive);
+}
+
+/// The adder kernel, 4 words at a time.
+template <class R>
+__attribute__((target("avx2")))
+void adder_run_avx2(const uint64_t* above, const uint64_t* mid, const uint64_t* below, uint64_t* out,
+                    size_t begin, size_t end, uint16_t birth, uint16_t survive){
+    adder_run<R, words4_t, 4>(above, mid, below, out, begin, end, birth, survive);
+}
+
+/// The adder kernel, 8 words at a time.
+template <class R>
+__attribute__((target("avx512f")))
+void adder_run_avx512(const uint64_t* above, const uint64_t* mid, const uint64_t* below, uint64_t* out,
+                      size_t begin, size_t end, uint16_t birth, uint16_t survive){
+    adder_run<R, words8_t, 8>(above, mid, below, out, begin, end, birth, survive);
+}
+#endif
+
+/// Returns the widest instruction set of the CPU the kernel is compiled for.
+inline simd_e simd_support(void){
+#ifdef LIFE_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")){return simd_e :: AVX512;}
+    if (__builtin_cpu_supports("avx2")){return simd_e :: AVX2;}
+    if (__builtin_cpu_supports("sse2")){return simd_e :: SSE2;}
+#endif
+    return simd_e :: SCALAR;
+}
+
+/// Returns the kernel of rule R for an instruction set, or a narrower one the CPU supports.
+template <class R>
+adder_run_t adder_run_for(simd_e isa){
+    if (static_cast<short>(isa) > static_cast<short>(simd_support())){isa = simd_support();}
+#ifdef LIFE_SIMD_X86
+    switch (isa){
+        case simd_e :: AVX512: return &adder_run_avx512<R>;
+        case simd_e :: AVX2: return &adder_run_avx2<R>;
+        case simd_e :: SSE2: return &adder_run_sse2<R>;
+        case simd_e :: SCALAR: break;
+    }
+#endif
+    return &adder_run_scalar<R>;
+}
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ * SlicedBoards class implementation.
+ *
+ */
+
+#include "sliced_boards.h"
+#include "adder.h"
+#include "zobrist.h"
+
+namespace life {
+
+/// Marks a ghost word whose cells are always dead.
+static constexpr size_t dead_ghost = static_cast<size_t>(-1);
+
+/**
+ * @brief Constructor for SlicedBoards class. Every cell of every board starts dead.
+ * @param rows # of rows of every board.
+ * @param cols # of columns of every board.
+ * @param boundary How the edges are glued together.
+ */
+SlicedBoards :: SlicedBoards(size_t rows, size_t cols, boundary_e boundary) :
+    m_rows(rows),
+    m_cols(cols),
+    m_stride(cols + 2),
+    m_boundary(boundary),
+    m_rule(),
+    m_cells((rows + 2) * (cols + 2), 0),
+    m_next((rows + 2) * (cols + 2), 0),
+    m_halo(),
+    m_keys(rows * cols, 0),
+    m_hash(),
+    m_alive(0),
+    m_step(&SlicedBoards :: step_adder<Conway>)
+    {
+        m_hash.fill(0);
+        const long long n_rows = static_cast<long long>(rows);
+        const long long n_cols = static_cast<long long>(cols);
+        for (long long r = -1; r <= n_rows; r++){
+            for (long long c = -1; c <= n_cols; c++){
+                if (r >= 0 && r < n_rows && c >= 0 && c < n_cols){continue;}
+                long long src_r = r, src_c = c;
+                const size_t ghost = static_cast<size_t>(r + 1) * m_stride + static_cast<size_t>(c + 1);
+                if (!boundary_source(m_boundary, rows, cols, src_r, src_c)){m_halo.emplace_back(ghost, dead_ghost);}
+                else {m_halo.emplace_back(ghost, at(static_cast<size_t>(src_r), static_cast<size_t>(src_c)));}
+            }
+        }
+        // Eight 6-bit fields of the Zobrist key of a cell name the hash bits it owns.
+        for (size_t r = 0; r < rows; r++){
+            for (size_t c = 0; c < cols; c++){
+                const uint64_t key = cell_key(r, c);
+                uint64_t bits = 0;
+                for (unsigned i = 0; i < 8; i++){bits |= uint64_t(1) << ((key >> (6 * i)) & 63);}
+                m_keys[r * cols + c] = bits;
+            }
+        }
+    }
+
+/**
+ * @brief Sets the state of a cell of one board.
+ * @param lane Board, 0 to 63.
+ * @param row Row index of the cell.
+ * @param col Column index of the cell.
+ * @param alive New state of the cell.
+ */
+void SlicedBoards :: set(size_t lane, size_t row, size_t col, bool alive){
+    const word_t bit = word_t(1) << lane;
+    word_t& word = m_cells[at(row, col)];
+    if (static_cast<bool>(word & bit) == alive){return;}
+    word ^= bit;
+    for (uint64_t k = m_keys[row * m_cols + col]; k != 0; k &= k - 1){m_hash[__builtin_ctzll(k)] ^= bit;}
+    if (alive){
+        m_alive |= bit;
+        return;
+    }
+    m_alive = 0;
+    for (size_t r = 0; r < m_rows; r++){
+        for (size_t c = 0; c < m_cols; c++){m_alive |= m_cells[at(r, c)];}
+    }
+};
+
+/**
+ * @brief Copies the cells past the edges into the halo.
+ */
+void SlicedBoards :: fill_halo(void){
+    for (const auto& ghost : m_halo){
+        m_cells[ghost.first] = (ghost.second == dead_ghost) ? 0 : m_cells[ghost.second];
+    }
+};
+
+/**
+ * @brief Advances every board one generation.
+ *
+ * The west, middle and east columns of the three rows around a word are
+ * its neighboring words, handed to adder_word() as they are. The words that
+ * change toggle the hash bits of their cell in the boards where they flip,
+ * and the boards left with an alive cell are collected on the way.
+ * The rule is a template parameter, so each rule gets its own loop.
+ */
+template <class R>
+void SlicedBoards :: step_adder(void){
+    const uint16_t birth = R :: birth(m_rule);
+    const uint16_t survive = R :: survive(m_rule);
+    const size_t stride = m_stride;
+    const size_t n_cols = m_cols;
+    word_t alive = 0;
+    for (size_t r = 0; r < m_rows; r++){
+        const word_t* x = m_cells.data() + at(r, 0);
+        word_t* y = m_next.data() + at(r, 0);
+        const uint64_t* keys = m_keys.data() + r * n_cols;
+        for (size_t c = 0; c < n_cols; c++){
+            const word_t* up = x + c - stride;
+            const word_t* down = x + c + stride;
+            const word_t west[3] = {up[-1], x[c - 1], down[-1]};
+            const word_t mid[3] = {up[0], x[c], down[0]};
+            const word_t east[3] = {up[1], x[c + 1], down[1]};
+            const word_t next = adder_word<R>(birth, survive, west, mid, east);
+            const word_t flips = next ^ x[c];
+            y[c] = next;
+            alive |= next;
+            if (flips == 0){continue;}
+            for (uint64_t k = keys[c]; k != 0; k &= k - 1){m_hash[__builtin_ctzll(k)] ^= flips;}
+        }
+    }
+    m_cells.swap(m_next);
+    m_alive = alive;
+};
+
+/**
+ * @brief Sets the birth and survival conditions of every board.
+ *
+ * The rules known at compile time get their own instantiation of the
+ * kernel; any other rule runs the generic one.
+ * @param rule Rule.
+ */
+void SlicedBoards :: rule(const Rule& rule){
+    m_rule = rule;
+    auto is = [this](uint16_t birth, uint16_t survive){ return m_rule.birth == birth && m_rule.survive == survive; };
+    if (m_rule == Rule()){m_step = &SlicedBoards :: step_adder<Conway>;}
+    else if (is(HighLife :: birth(m_rule), HighLife :: survive(m_rule))){m_step = &SlicedBoards :: step_adder<HighLife>;}
+    else if (is(DayAndNight :: birth(m_rule), DayAndNight :: survive(m_rule))){m_step = &SlicedBoards :: step_adder<DayAndNight>;}
+    else if (is(Seeds :: birth(m_rule), Seeds :: survive(m_rule))){m_step = &SlicedBoards :: step_adder<Seeds>;}
+    else if (is(LifeWithoutDeath :: birth(m_rule), LifeWithoutDeath :: survive(m_rule))){m_step = &SlicedBoards :: step_adder<LifeWithoutDeath>;}
+    else {m_step = &SlicedBoards :: step_adder<AnyRule>;}
+};
+
+/**
+ * @brief Advances every board by several generations.
+ * @param generations # of generations.
+ */
+void SlicedBoards :: step(unsigned long long generations){
+    for (unsigned long long i = 0; i < generations; i++){
+        fill_halo();
+        (this->*m_step)();
+    }
+};
+
+/**
+ * @brief Writes the fingerprint of every board.
+ *
+ * The hash bits are kept one word per bit, for the 64 boards; the 64x64
+ * bit matrix is transposed in six rounds of block swaps, halving the block
+ * each round.
+ * @param out Receives the fingerprint of board k at out[k].
+ */
+void SlicedBoards :: fingerprints(std :: array<uint64_t, lanes>& out) const{
+    out = m_hash;
+    uint64_t mask = 0x00000000ffffffffULL;
+    for (unsigned j = 32; j != 0; j >>= 1, mask ^= mask << j){
+        for (unsigned k = 0; k < lanes; k = (k + j + 1) & ~j){
+            const uint64_t t = ((out[k] >> j) ^ out[k + j]) & mask;
+            out[k] ^= t << j;
+            out[k + j] ^= t;
+        }
+    }
+};
+
+/**
+ * @brief Copies one board of another set of boards of the same size.
+ * @param other Boards to copy from.
+ * @param lane Board, 0 to 63, both in other and here.
+ */
+void SlicedBoards :: copy_lane(const SlicedBoards& other, size_t lane){
+    for (size_t r = 0; r < m_rows; r++){
+        for (size_t c = 0; c < m_cols; c++){set(lane, r, c, other.get(lane, r, c));}
+    }
+};
+
+/**
+ * @brief Compares every board with the same board of another set, exactly.
+ * @param other Boards of the same size.
+ * @return Bit k is set if board k is equal in both sets.
+ */
+SlicedBoards :: word_t SlicedBoards :: equal(const SlicedBoards& other) const{
+    word_t same = ~word_t(0);
+    for (size_t r = 0; r < m_rows; r++){
+        for (size_t c = 0; c < m_cols; c++){same &= ~(m_cells[at(r, c)] ^ other.m_cells[at(r, c)]);}
+    }
+    return same;
+};
+
+}  // namespace life
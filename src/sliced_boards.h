@@ -0,0 +1,106 @@
+//! This class implements 64 small boards stepped at once.
+/*!
+ * @file sliced_boards.h
+ *
+ * @details Class SlicedBoards, a bit-sliced engine: bit k of every word
+ * belongs to board k, so one pass of the adder kernel advances 64
+ * simulations of the same geometry.
+ */
+
+#ifndef _SLICED_BOARDS_H_
+#define _SLICED_BOARDS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "boundary.h"
+#include "rule.h"
+
+namespace life {
+
+/// 64 boards of the same size, rule and topology, one per bit of a word.
+/*!
+ * Word (row, col) holds cell (row, col) of the 64 boards, so the neighbors
+ * of a cell are the neighboring words and need no shifting: the adder kernel
+ * of BitBoard (see adder.h) decides a cell of every board with a few dozen
+ * instructions. Small boards gain the most, since a lone 8x8 board fills a
+ * fraction of a single BitBoard word.
+ *
+ * The words are surrounded by a halo, refilled every generation from the
+ * cells its ghost cells stand for (see boundary.h).
+ *
+ * Each board has a fingerprint, kept as 64 hash bits per board. Every cell
+ * owns a few of the 64 bits (its key), and a flip of the cell toggles them,
+ * so the fingerprints of the 64 boards are updated together, a word of
+ * boards per bit, from the words that change. Equal boards have equal
+ * fingerprints; different ones almost never do, but matches must still be
+ * confirmed.
+ */
+class SlicedBoards {
+    public:
+    typedef uint64_t word_t;                    //!< Cell of the 64 boards.
+    static constexpr size_t lanes = 64;         //!< # of boards.
+
+    private:
+    size_t m_rows;                              //!< # of rows of every board.
+    size_t m_cols;                              //!< # of columns of every board.
+    size_t m_stride;                            //!< # of words per row, halo included.
+    boundary_e m_boundary;                      //!< How the edges are glued together.
+    Rule m_rule;                                //!< Birth and survival conditions.
+    std::vector<word_t> m_cells;                //!< Current words, halo included.
+    std::vector<word_t> m_next;                 //!< Next words, halo included.
+    std::vector<std::pair<size_t, size_t>> m_halo;  //!< Ghost words, and the words they copy (npos: dead).
+    std::vector<uint64_t> m_keys;               //!< Hash bits owned by each cell.
+    std::array<word_t, lanes> m_hash;           //!< Hash bit b of board k is bit k of m_hash[b].
+    word_t m_alive;                             //!< Boards with an alive cell.
+    void (SlicedBoards::*m_step)(void);         //!< Kernel of the rule.
+
+    //!< Returns the index of a cell in the words.
+    size_t at(size_t row, size_t col) const { return (row + 1) * m_stride + col + 1; }
+
+    //!< Copies the cells past the edges into the halo.
+    void fill_halo(void);
+
+    //!< Advances the boards one generation, with the kernel of rule R.
+    template <class R>
+    void step_adder(void);
+
+    public:
+    SlicedBoards(size_t rows, size_t cols, boundary_e boundary = boundary_e :: TORUS);
+
+    //!< Returns the # of rows of every board.
+    size_t rows(void) const { return m_rows; }
+
+    //!< Returns the # of columns of every board.
+    size_t cols(void) const { return m_cols; }
+
+    //!< Returns true if the cell of the given board is alive.
+    bool get(size_t lane, size_t row, size_t col) const { return (m_cells[at(row, col)] >> lane) & 1; }
+
+    //!< Sets the state of a cell of the given board.
+    void set(size_t lane, size_t row, size_t col, bool alive);
+
+    //!< Returns the boards that have an alive cell, one per bit.
+    word_t alive(void) const { return m_alive; }
+
+    //!< Sets the birth and survival conditions of every board.
+    void rule(const Rule& rule);
+
+    //!< Advances every board by the given # of generations.
+    void step(unsigned long long generations);
+
+    //!< Writes the fingerprint of every board.
+    void fingerprints(std::array<uint64_t, lanes>& out) const;
+
+    //!< Copies board `lane` of other into board `lane`.
+    void copy_lane(const SlicedBoards& other, size_t lane);
+
+    //!< Returns the boards equal to the same board of other, one per bit.
+    word_t equal(const SlicedBoards& other) const;
+};
+
+}  // namespace life
+
+#endif
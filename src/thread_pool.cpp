@@ -0,0 +1,119 @@
+/**
+ * ThreadPool class implementation.
+ *
+ */
+
+#include "thread_pool.h"
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace life {
+
+/**
+ * @brief Constructor for ThreadPool class.
+ * @param n_threads # of workers, the calling thread included (at least 1).
+ * @param pinned True to pin every worker to a CPU of its own.
+ */
+ThreadPool :: ThreadPool(size_t n_threads, bool pinned) :
+    m_threads(),
+    m_mutex(),
+    m_wake(),
+    m_done(),
+    m_job(nullptr),
+    m_epoch(0),
+    m_pending(0),
+    m_quit(false)
+    {
+        for (size_t i = 1; i < n_threads; i++){
+            m_threads.emplace_back(&ThreadPool :: work, this, i);
+        }
+        if (pinned){pin();}
+    }
+
+/**
+ * @brief Pins worker i to the i-th CPU of the affinity mask of the calling
+ * thread (wrapping around if there are more workers than CPUs).
+ *
+ * Consecutive workers, which step neighboring bands, get consecutive CPUs,
+ * usually on the same socket. Pinning is a hint: where it is not supported
+ * or fails, the workers stay where the OS puts them.
+ */
+void ThreadPool :: pin(void){
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0){return;}
+    std :: vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++){
+        if (CPU_ISSET(cpu, &allowed)){cpus.push_back(cpu);}
+    }
+    if (cpus.empty()){return;}
+    for (size_t worker = 0; worker < size(); worker++){
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpus[worker % cpus.size()], &one);
+        const pthread_t thread = (worker == 0) ? pthread_self() : m_threads[worker - 1].native_handle();
+        pthread_setaffinity_np(thread, sizeof(one), &one);
+    }
+#endif
+};
+
+/**
+ * @brief Destructor for ThreadPool class. Joins every worker.
+ */
+ThreadPool :: ~ThreadPool(){
+    {
+        std :: lock_guard<std :: mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads){thread.join();}
+};
+
+/**
+ * @brief Waits for jobs and runs them until the pool is destroyed.
+ * @param worker Index of this worker.
+ */
+void ThreadPool :: work(size_t worker){
+    size_t seen = 0;
+    while (true){
+        const job_t* job = nullptr;
+        {
+            std :: unique_lock<std :: mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]{ return m_quit || m_epoch != seen; });
+            if (m_quit){return;}
+            seen = m_epoch;
+            job = m_job;
+        }
+        (*job)(worker);
+        {
+            std :: lock_guard<std :: mutex> lock(m_mutex);
+            if (--m_pending == 0){m_done.notify_one();}
+        }
+    }
+};
+
+/**
+ * @brief Runs a job on every worker and returns when all of them finished.
+ * @param job Function called once per worker, with the worker index.
+ */
+void ThreadPool :: run(const job_t& job){
+    if (m_threads.empty()){
+        job(0);
+        return;
+    }
+    {
+        std :: lock_guard<std :: mutex> lock(m_mutex);
+        m_job = &job;
+        m_pending = m_threads.size();
+        m_epoch++;
+    }
+    m_wake.notify_all();
+    job(0);
+    std :: unique_lock<std :: mutex> lock(m_mutex);
+    m_done.wait(lock, [&]{ return m_pending == 0; });
+};
+
+}  // namespace life
@@ -0,0 +1,65 @@
+//! This class implements a persistent pool of worker threads.
+/*!
+ * @file thread_pool.h
+ *
+ * @details Class ThreadPool, used to step the board in parallel.
+ */
+
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace life {
+
+/// A fixed set of threads that run the same job once per call to `run()`.
+/*!
+ * The threads are created once and sleep between jobs. `run()` hands the job
+ * to every worker, runs the share of worker 0 on the calling thread and
+ * returns when all of them are done, so each call costs exactly one barrier.
+ *
+ * The workers may be pinned, worker i to the i-th CPU the process may run
+ * on, so that each one keeps its caches, and the memory it touched first
+ * stays on its NUMA node.
+ */
+class ThreadPool {
+    public:
+    typedef std::function<void(size_t worker)> job_t;   //!< Job run by each worker.
+
+    private:
+    std::vector<std::thread> m_threads;     //!< Workers 1..size()-1.
+    std::mutex m_mutex;                     //!< Guards every member below.
+    std::condition_variable m_wake;         //!< Signals a new job (or shutdown).
+    std::condition_variable m_done;         //!< Signals the end of a job.
+    const job_t* m_job;                     //!< Job being run.
+    size_t m_epoch;                         //!< # of jobs started so far.
+    size_t m_pending;                       //!< # of workers still running the job.
+    bool m_quit;                            //!< Flag to end the workers.
+
+    //!< Body of the background workers.
+    void work(size_t worker);
+
+    //!< Pins every worker, the calling thread included, to a CPU of its own.
+    void pin(void);
+
+    public:
+    explicit ThreadPool(size_t n_threads, bool pinned = false);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    //!< Returns the # of workers, the calling thread included.
+    size_t size(void) const { return m_threads.size() + 1; }
+
+    //!< Runs `job(worker)` for every worker and waits for all of them.
+    void run(const job_t& job);
+};
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * TileHistory class implementation.
+ *
+ */
+
+#include "tile_history.h"
+#include <utility>
+
+namespace life {
+
+/**
+ * @brief Constructor for TileHistory class.
+ * @param rows # of rows of the boards.
+ * @param cols # of columns of the boards.
+ */
+TileHistory :: TileHistory(size_t rows, size_t cols) :
+    m_grid_rows(0),
+    m_grid_cols(0),
+    m_empty(std :: make_shared<const tile_t>(tile_words, 0)),
+    m_index(),
+    m_entries(),
+    m_first(0),
+    m_epoch(0),
+    m_recorded(false),
+    m_bytes(0),
+    m_max_bytes(0),
+    m_evicted(0)
+    {
+        resize(rows, cols);
+    }
+
+/**
+ * @brief Sets the size of the boards. Every recorded board is forgotten.
+ * @param rows # of rows of the boards.
+ * @param cols # of columns of the boards.
+ */
+void TileHistory :: resize(size_t rows, size_t cols){
+    m_grid_rows = (rows + tile_side - 1) / tile_side;
+    m_grid_cols = (cols + tile_side - 1) / tile_side;
+    m_index.clear();
+    m_entries.clear();
+    m_first = 0;
+    m_recorded = false;
+    m_bytes = 0;
+    m_evicted = 0;
+};
+
+/**
+ * @brief Records the board of an engine, unless it repeats a past board.
+ *
+ * Each tile is taken from the previous board when the engine stamps show
+ * it did not change since then; otherwise it is read, and still taken from
+ * the previous board (or the empty tile) if its cells are the same.
+ * @param table Engine holding the board, stepped since the previous call.
+ * @param gen Generation of the board; on a match, receives the generation of the past board.
+ * @return True if the board repeats a past one.
+ */
+bool TileHistory :: insert(Engine& table, unsigned long long& gen){
+    const std :: vector<tile_ptr>* previous = m_entries.empty() ? nullptr : &m_entries.back().tiles;
+    const bool stamped = m_recorded && previous != nullptr && table.tile_size() == tile_side;
+    Entry entry{table.fingerprint(), gen, {}};
+    entry.tiles.reserve(m_grid_rows * m_grid_cols);
+    tile_t cells(tile_words);
+    size_t new_bytes = 0;
+    for (size_t tr = 0; tr < m_grid_rows; tr++){
+        for (size_t tc = 0; tc < m_grid_cols; tc++){
+            const size_t tile = tr * m_grid_cols + tc;
+            if (stamped && table.tile_stamp(tr, tc) <= m_epoch){
+                entry.tiles.push_back((*previous)[tile]);
+                continue;
+            }
+            table.read_tile(tr, tc, tile_side, cells.data());
+            if (previous != nullptr && *(*previous)[tile] == cells){entry.tiles.push_back((*previous)[tile]);}
+            else if (cells == *m_empty){entry.tiles.push_back(m_empty);}
+            else {
+                entry.tiles.push_back(std :: make_shared<const tile_t>(cells));
+                new_bytes += tile_words * sizeof(uint64_t);
+            }
+        }
+    }
+    auto range = m_index.equal_range(entry.fingerprint);
+    for (auto it = range.first; it != range.second; ++it){
+        const Entry& past = m_entries[it->second - m_first];
+        bool equal = true;
+        for (size_t tile = 0; tile < entry.tiles.size() && equal; tile++){
+            equal = past.tiles[tile] == entry.tiles[tile] || *past.tiles[tile] == *entry.tiles[tile];
+        }
+        if (equal){
+            gen = past.gen;
+            // The newest board kept is not this one: the stamps no longer apply.
+            m_recorded = false;
+            return true;
+        }
+    }
+
+    m_bytes += new_bytes + entry.tiles.size() * sizeof(tile_ptr) + sizeof(Entry);
+    m_index.emplace(entry.fingerprint, m_first + m_entries.size());
+    m_entries.push_back(std :: move(entry));
+    m_epoch = table.epoch();
+    m_recorded = true;
+    // The newest board is always kept: the next one is built from it.
+    while (m_max_bytes != 0 && m_bytes > m_max_bytes && m_entries.size() > 1){evict();}
+    return false;
+};
+
+/**
+ * @brief Drops the oldest board. Its tiles that no other board uses are freed.
+ */
+void TileHistory :: evict(void){
+    Entry& entry = m_entries.front();
+    auto range = m_index.equal_range(entry.fingerprint);
+    for (auto it = range.first; it != range.second; ++it){
+        if (it->second == m_first){
+            m_index.erase(it);
+            break;
+        }
+    }
+    for (const tile_ptr& tile : entry.tiles){
+        if (tile != m_empty && tile.use_count() == 1){m_bytes -= tile_words * sizeof(uint64_t);}
+    }
+    m_bytes -= entry.tiles.size() * sizeof(tile_ptr) + sizeof(Entry);
+    m_entries.pop_front();
+    m_first++;
+    m_evicted++;
+};
+
+}  // namespace life
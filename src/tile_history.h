@@ -0,0 +1,92 @@
+//! This class implements the set of boards already generated, as shared tiles.
+/*!
+ * @file tile_history.h
+ *
+ * @details Class TileHistory, used to detect that a simulation became stable
+ * while storing only the tiles that changed between generations.
+ */
+
+#ifndef _TILE_HISTORY_H_
+#define _TILE_HISTORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "engine.h"
+
+namespace life {
+
+/// Past boards, each a list of references to immutable 64x64 tiles.
+/*!
+ * A board is recorded as one pointer per tile. A tile that did not change
+ * since the previous board is not copied: the new board points to the same
+ * tile (copy on write), and empty tiles all point to a single shared tile.
+ * Settled debris therefore costs one pointer per generation, and when the
+ * engine tracks changes per tile (see Engine::tile_stamp()) the unchanged
+ * tiles are not even read.
+ *
+ * Boards are indexed by fingerprint; tiles are only compared when
+ * fingerprints collide. When a memory limit is set, the oldest boards are
+ * dropped to stay under it, as in History.
+ */
+class TileHistory {
+    public:
+    static constexpr size_t tile_side = 64;                     //!< # of rows and columns of a tile.
+    static constexpr size_t tile_words = tile_side * tile_side / 64;  //!< # of words of a tile.
+    typedef std::vector<uint64_t> tile_t;                       //!< Cells of a tile, one word per row.
+    typedef std::shared_ptr<const tile_t> tile_ptr;             //!< Shared, immutable tile.
+
+    private:
+    /// A past board.
+    struct Entry {
+        uint64_t fingerprint;           //!< Fingerprint of the board.
+        unsigned long long gen;         //!< Generation of the board.
+        std::vector<tile_ptr> tiles;    //!< Tiles of the board, row-major.
+    };
+
+    size_t m_grid_rows;                                 //!< # of tile rows.
+    size_t m_grid_cols;                                 //!< # of tile columns.
+    tile_ptr m_empty;                                   //!< The tile shared by every empty tile.
+    std::unordered_multimap<uint64_t, size_t> m_index;  //!< Fingerprint to entry # (counted from the first entry ever).
+    std::deque<Entry> m_entries;                        //!< Boards still kept, oldest first.
+    size_t m_first;                                     //!< Entry # of m_entries.front().
+    unsigned long long m_epoch;                         //!< Engine epoch when the newest board was recorded.
+    bool m_recorded;                                    //!< Flag to check if a board was recorded since resize().
+    size_t m_bytes;                                     //!< Memory used by the boards kept.
+    size_t m_max_bytes;                                 //!< Memory limit (0: none).
+    unsigned long long m_evicted;                       //!< # of boards dropped to honor the limit.
+
+    //!< Drops the oldest board, and the tiles only it used.
+    void evict(void);
+
+    public:
+    TileHistory(size_t rows = 0, size_t cols = 0);
+
+    //!< Sets the board size and forgets every board.
+    void resize(size_t rows, size_t cols);
+
+    //!< Sets the memory limit, in bytes (0: none).
+    void limit(size_t max_bytes) { m_max_bytes = max_bytes; }
+
+    //!< Records the board of an engine, unless it repeats a past one; then gen receives the generation of that one.
+    bool insert(Engine& table, unsigned long long& gen);
+
+    //!< Returns the # of boards kept.
+    size_t size(void) const { return m_entries.size(); }
+
+    //!< Returns the memory used by the boards kept, in bytes.
+    size_t bytes(void) const { return m_bytes; }
+
+    //!< Returns the # of boards dropped to honor the memory limit.
+    unsigned long long evicted(void) const { return m_evicted; }
+
+    //!< Returns the generation of the oldest board kept.
+    unsigned long long oldest(void) const { return m_entries.empty() ? 0 : m_entries.front().gen; }
+};
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * TranslationHistory class implementation.
+ *
+ */
+
+#include "translation_history.h"
+#include "zobrist.h"
+
+namespace life {
+
+/**
+ * @brief Constructor for TranslationHistory class.
+ * @param rows # of rows of the boards.
+ * @param cols # of columns of the boards.
+ */
+TranslationHistory :: TranslationHistory(size_t rows, size_t cols) :
+    m_rows(0),
+    m_cols(0),
+    m_words(0),
+    m_boards()
+    {
+        resize(rows, cols);
+    }
+
+/**
+ * @brief Sets the size of the boards. Every recorded board is forgotten.
+ * @param rows # of rows of the boards.
+ * @param cols # of columns of the boards.
+ */
+void TranslationHistory :: resize(size_t rows, size_t cols){
+    m_rows = rows;
+    m_cols = cols;
+    m_words = (cols + 63) / 64;
+    m_boards.clear();
+};
+
+/**
+ * @brief Counts the alive cells of every row and column of a board.
+ * @param board Snapshot of the board.
+ * @param rows Receives the count of each row.
+ * @param cols Receives the count of each column.
+ */
+void TranslationHistory :: count(const snapshot_t& board, std :: vector<uint32_t>& rows, std :: vector<uint32_t>& cols) const{
+    rows.assign(m_rows, 0);
+    cols.assign(m_cols, 0);
+    for (size_t r = 0; r < m_rows; r++){
+        for (size_t w = 0; w < m_words; w++){
+            for (uint64_t bits = board[r * m_words + w]; bits != 0; bits &= bits - 1){
+                rows[r]++;
+                cols[w * 64 + static_cast<size_t>(__builtin_ctzll(bits))]++;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Computes a key that does not change when the board is shifted.
+ *
+ * Shifting rotates the row and column counts, which keeps every pair of
+ * adjacent counts (wrapping around). The pairs are hashed and summed, so
+ * their order does not matter either.
+ * @param rows Count of each row.
+ * @param cols Count of each column.
+ * @return Key of the board.
+ */
+uint64_t TranslationHistory :: key(const std :: vector<uint32_t>& rows, const std :: vector<uint32_t>& cols){
+    uint64_t population = 0;
+    uint64_t row_sum = 0;
+    uint64_t col_sum = 0;
+    for (size_t i = 0; i < rows.size(); i++){
+        population += rows[i];
+        row_sum += cell_key(rows[i], rows[i + 1 == rows.size() ? 0 : i + 1]);
+    }
+    for (size_t i = 0; i < cols.size(); i++){
+        col_sum += cell_key(cols[i], cols[i + 1 == cols.size() ? 0 : i + 1]);
+    }
+    return cell_key(population, rows.size()) ^ row_sum ^ ((col_sum << 32) | (col_sum >> 32));
+};
+
+/**
+ * @brief Lists the rotations that turn a sequence of counts into another.
+ * @param now Counts of the current board.
+ * @param old Counts of the past board.
+ * @param out Receives every shift s with now[i] == old[(i - s) mod n].
+ */
+void TranslationHistory :: shifts(const std :: vector<uint32_t>& now, const std :: vector<uint32_t>& old, std :: vector<size_t>& out){
+    const size_t n = now.size();
+    out.clear();
+    for (size_t s = 0; s < n; s++){
+        bool equal = true;
+        for (size_t i = 0; i < n && equal; i++){
+            equal = now[i] == old[(i + n - s) % n];
+        }
+        if (equal){out.push_back(s);}
+    }
+};
+
+/**
+ * @brief Checks whether a board is a past board shifted around the torus.
+ * @param board Snapshot of the current board.
+ * @param old Snapshot of the past board.
+ * @param dy # of rows the past board moved down.
+ * @param dx # of columns the past board moved right.
+ * @return True if every cell (r, c) of board is cell (r - dy, c - dx) of old.
+ */
+bool TranslationHistory :: matches(const snapshot_t& board, const snapshot_t& old, size_t dy, size_t dx) const{
+    if (dy == 0 && dx == 0){return board == old;}
+    for (size_t r = 0; r < m_rows; r++){
+        const uint64_t* now_row = &board[r * m_words];
+        const uint64_t* old_row = &old[(r + m_rows - dy) % m_rows * m_words];
+        for (size_t c = 0; c < m_cols; c++){
+            size_t from = (c + m_cols - dx) % m_cols;
+            if (((now_row[c / 64] >> (c % 64)) & 1) != ((old_row[from / 64] >> (from % 64)) & 1)){return false;}
+        }
+    }
+    return true;
+};
+
+/**
+ * @brief Records a board, unless it is a past board shifted around the torus.
+ * @param gen Generation of the board; on a match, receives the generation of the past board.
+ * @param snapshot The board.
+ * @param dy On a match, # of rows the board moved down since then (negative: up).
+ * @param dx On a match, # of columns the board moved right since then (negative: left).
+ * @return True if the board repeats a past one.
+ */
+bool TranslationHistory :: insert(unsigned long long& gen, const snapshot_t& snapshot, long long& dy, long long& dx){
+    std :: vector<uint32_t> rows, cols;
+    count(snapshot, rows, cols);
+    const uint64_t k = key(rows, cols);
+    std :: vector<uint32_t> old_rows, old_cols;
+    std :: vector<size_t> row_shifts, col_shifts;
+    auto shifted = [&](const snapshot_t& old){
+        count(old, old_rows, old_cols);
+        shifts(rows, old_rows, row_shifts);
+        shifts(cols, old_cols, col_shifts);
+        for (size_t sy : row_shifts){
+            for (size_t sx : col_shifts){
+                if (!matches(snapshot, old, sy, sx)){continue;}
+                // The shortest way around the torus.
+                dy = (2 * sy > m_rows) ? static_cast<long long>(sy) - static_cast<long long>(m_rows) : static_cast<long long>(sy);
+                dx = (2 * sx > m_cols) ? static_cast<long long>(sx) - static_cast<long long>(m_cols) : static_cast<long long>(sx);
+                return true;
+            }
+        }
+        return false;
+    };
+    if (m_boards.find_if(k, shifted, gen)){return true;}
+    m_boards.insert(k, gen, snapshot);
+    return false;
+};
+
+}  // namespace life
@@ -0,0 +1,70 @@
+//! This class implements the set of boards already generated, up to translation.
+/*!
+ * @file translation_history.h
+ *
+ * @details Class TranslationHistory, used to detect that a toroidal
+ * simulation repeats itself shifted, as spaceships crossing the board do.
+ */
+
+#ifndef _TRANSLATION_HISTORY_H_
+#define _TRANSLATION_HISTORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "history.h"
+
+namespace life {
+
+/// Past boards of a torus, indexed by a translation-invariant key.
+/*!
+ * Boards are snapshots of `rows x cols` cells, 64 per word, rows padded to
+ * whole words (the layout of the toroidal engines). The key of a board
+ * combines its population with the multisets of adjacent pairs of row and
+ * column counts, which shifting the board around the torus does not change.
+ * Boards with the same key are then compared under every shift that lines
+ * their row and column counts up. The boards are kept in a History, so they
+ * are stored compressed and honor its memory limit.
+ */
+class TranslationHistory {
+    public:
+    typedef History::snapshot_t snapshot_t;     //!< Compact copy of a board.
+
+    private:
+    size_t m_rows;          //!< # of rows of the boards.
+    size_t m_cols;          //!< # of columns of the boards.
+    size_t m_words;         //!< # of words per row of the snapshots.
+    History m_boards;       //!< Past boards, indexed by translation-invariant key.
+
+    //!< Counts the alive cells of every row and column of a board.
+    void count(const snapshot_t& board, std::vector<uint32_t>& rows, std::vector<uint32_t>& cols) const;
+
+    //!< Returns the translation-invariant key of a board, given its counts.
+    static uint64_t key(const std::vector<uint32_t>& rows, const std::vector<uint32_t>& cols);
+
+    //!< Lists the shifts s with now[i] == old[i - s] for every i (indices wrap).
+    static void shifts(const std::vector<uint32_t>& now, const std::vector<uint32_t>& old, std::vector<size_t>& out);
+
+    //!< Returns true if board is old shifted by dy rows and dx columns.
+    bool matches(const snapshot_t& board, const snapshot_t& old, size_t dy, size_t dx) const;
+
+    public:
+    TranslationHistory(size_t rows = 0, size_t cols = 0);
+
+    //!< Sets the board size and forgets every board.
+    void resize(size_t rows, size_t cols);
+
+    //!< Returns the boards, to set their memory limit or query their eviction.
+    History& boards(void) { return m_boards; }
+    const History& boards(void) const { return m_boards; }
+
+    //!< Records a board, unless it repeats a past one shifted; then gen, dy and dx describe the match.
+    bool insert(unsigned long long& gen, const snapshot_t& snapshot, long long& dy, long long& dx);
+
+    //!< Returns the # of boards kept.
+    size_t size(void) const { return m_boards.size(); }
+};
+
+}  // namespace life
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * WorkStealing class implementation.
+ *
+ */
+
+#include "work_stealing.h"
+
+namespace life {
+
+namespace {
+    /// Packs a [head, tail) range into one word.
+    inline uint64_t pack(uint64_t head, uint64_t tail){ return head | (tail << 32); }
+}
+
+/**
+ * @brief Constructor for WorkStealing class.
+ */
+WorkStealing :: WorkStealing() :
+    m_deques(),
+    m_workers(0)
+    {}
+
+/**
+ * @brief Deals a new batch of tasks among the workers.
+ * @param n_tasks # of tasks, identified by 0 .. n_tasks - 1.
+ * @param n_workers # of workers (one deque each).
+ */
+void WorkStealing :: reset(size_t n_tasks, size_t n_workers){
+    if (n_workers != m_workers){
+        m_deques.reset(new Deque[n_workers]);
+        m_workers = n_workers;
+    }
+    for (size_t i = 0; i < n_workers; i++){
+        uint64_t head = i * n_tasks / n_workers;
+        uint64_t tail = (i + 1) * n_tasks / n_workers;
+        m_deques[i].range.store(pack(head, tail), std :: memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Removes one task from a deque.
+ * @param deque Deque to take the task from.
+ * @param from_back True to steal the last task, false to pop the first one.
+ * @param task The task taken.
+ * @return False if the deque was empty.
+ */
+bool WorkStealing :: take(Deque& deque, bool from_back, size_t& task){
+    uint64_t range = deque.range.load(std :: memory_order_relaxed);
+    while (true){
+        uint64_t head = range & 0xffffffffu;
+        uint64_t tail = range >> 32;
+        if (head >= tail){return false;}
+        uint64_t next = from_back ? pack(head, tail - 1) : pack(head + 1, tail);
+        if (deque.range.compare_exchange_weak(range, next, std :: memory_order_acq_rel)){
+            task = static_cast<size_t>(from_back ? tail - 1 : head);
+            return true;
+        }
+    }
+};
+
+/**
+ * @brief Gets the next task for a worker.
+ * @param worker Index of the worker asking.
+ * @param task The task to run.
+ * @return False when every deque is empty.
+ */
+bool WorkStealing :: next(size_t worker, size_t& task){
+    if (take(m_deques[worker], false, task)){return true;}
+    for (size_t k = 1; k < m_workers; k++){
+        if (take(m_deques[(worker + k) % m_workers], true, task)){return true;}
+    }
+    return false;
+};
+
+}  // namespace life
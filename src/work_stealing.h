@@ -0,0 +1,55 @@
+//! This class implements per-worker task deques with work stealing.
+/*!
+ * @file work_stealing.h
+ *
+ * @details Class WorkStealing, a scheduler for a batch of indexed tasks.
+ */
+
+#ifndef _WORK_STEALING_H_
+#define _WORK_STEALING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace life {
+
+/// Deals a batch of tasks `[0, n)` to per-worker deques, with stealing.
+/*!
+ * Each worker starts with a contiguous range of task indices (so that
+ * neighboring tiles are stepped by the same core) and takes tasks from the
+ * front of its own deque. A worker whose deque is empty steals from the back
+ * of another worker's deque, so a region that holds most of the work is
+ * shared by every core instead of stalling the one that owns it.
+ *
+ * The tasks of a batch are known up front, so a deque is just a `[head,
+ * tail)` range packed into one atomic word; both pops and steals are a
+ * single compare-and-swap.
+ */
+class WorkStealing {
+    private:
+    /// A deque, alone in its cache line to avoid false sharing.
+    struct alignas(64) Deque {
+        std::atomic<uint64_t> range;    //!< head in the low half, tail in the high half.
+    };
+
+    std::unique_ptr<Deque[]> m_deques;  //!< One deque per worker.
+    size_t m_workers;                   //!< # of deques.
+
+    //!< Takes the first (own deque) or last (stolen) task of a deque.
+    static bool take(Deque& deque, bool from_back, size_t& task);
+
+    public:
+    WorkStealing();
+
+    //!< Deals tasks [0, n_tasks) among n_workers deques. Not thread safe.
+    void reset(size_t n_tasks, size_t n_workers);
+
+    //!< Gets the next task of a worker, stealing if needed. False when all are done.
+    bool next(size_t worker, size_t& task);
+};
+
+}  // namespace life
+
+#endif
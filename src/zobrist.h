@@ -0,0 +1,48 @@
+//! Zobrist keys of the cells of a board.
+/*!
+ * @file zobrist.h
+ *
+ * @details The fingerprint of a board is the XOR of the keys of its alive
+ * cells, so flipping a cell changes the fingerprint by exactly its key.
+ * Bit-packed boards key whole words instead, so a word where many cells
+ * flip costs two keys rather than one per cell.
+ */
+
+#ifndef _ZOBRIST_H_
+#define _ZOBRIST_H_
+
+#include <cstdint>
+
+namespace life {
+
+/// Returns a 64-bit value whose bits all depend on every bit of z (splitmix64 finalizer).
+inline uint64_t mix64(uint64_t z){
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/// Returns the pseudo-random 64-bit key of cell (row, col).
+/*!
+ * The keys are computed (splitmix64 finalizer) instead of stored, so huge
+ * boards need no key table and every engine agrees on the same keys.
+ */
+inline uint64_t cell_key(uint64_t row, uint64_t col){
+    return mix64((row << 32) ^ col ^ 0x6a09e667f3bcc909ULL);
+}
+
+/// Returns the pseudo-random 64-bit key of a word of cells at a given index.
+/*!
+ * The index is mixed on its own before it meets the word, so the keys of
+ * two indices differ by an unrelated value and not by a multiple of a
+ * constant, which patterns could line up with. An empty word has key 0, so
+ * an empty board has fingerprint 0 whatever its size, as with cell_key().
+ */
+inline uint64_t word_key(uint64_t index, uint64_t word){
+    if (word == 0){return 0;}
+    return mix64(word ^ mix64(index + 0x9e3779b97f4a7c15ULL));
+}
+
+}  // namespace life
+
+#endif